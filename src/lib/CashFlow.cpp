@@ -0,0 +1,227 @@
+#include "CashFlow.hpp"
+
+#include "Parallel.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace tug
+{
+
+namespace
+{
+
+constexpr auto blockSize     = std::size_t{1024};
+constexpr auto irrIterations = 64;
+constexpr auto irrLow        = -0.99;
+constexpr auto irrHigh       = 10.0;
+
+// Structure of arrays of all investments [EUR, USD, years]
+struct Columns
+{
+    explicit Columns(std::span<Investment const> investments)
+    {
+        for (auto const& investment : investments)
+        {
+            auto const assets = std::array{investment.container, investment.lights, investment.panels};
+            auto capex        = 0.0;
+            auto depreciation = 0.0;
+            for (auto a = std::size_t{0}; a < assets.size(); ++a)
+            {
+                auto const cost = assets[a].capex.numerical_value_in(finance::euro);
+                capex += cost;
+                if (assets[a].life > 0) { depreciation += cost / assets[a].life; }
+                price[a].push_back(cost);
+                life[a].push_back(assets[a].life);
+            }
+
+            initial.push_back(capex);
+            this->depreciation.push_back(depreciation);
+            revenue.push_back(investment.revenue.numerical_value_in(finance::euro));
+            opex.push_back(investment.opex.numerical_value_in(finance::euro));
+            seeds.push_back(investment.seeds.numerical_value_in(finance::us_dollar));
+        }
+    }
+
+    std::array<std::vector<double>, 3> price;
+    std::array<std::vector<int>, 3> life;
+    std::vector<double> initial;
+    std::vector<double> depreciation;
+    std::vector<double> revenue;
+    std::vector<double> opex;
+    std::vector<double> seeds;
+};
+
+// Sum of flow[y] / (1 + rate)^y evaluated with Horner's scheme
+auto presentValues(CashFlows const& cf, int years, std::size_t first, std::size_t count, double const* rate,
+                   double* out) -> void
+{
+    auto const* last = cf.flows.data() + static_cast<std::size_t>(years) * cf.scenarios + first;
+    std::copy(last, last + count, out);
+    for (auto y = years - 1; y >= 0; --y)
+    {
+        auto const* row = cf.flows.data() + static_cast<std::size_t>(y) * cf.scenarios + first;
+        for (auto i = std::size_t{0}; i < count; ++i) { out[i] = row[i] + out[i] / (1.0 + rate[i]); }
+    }
+}
+
+}  // namespace
+
+auto evaluateCashFlows(CashFlowModel const& model, std::span<Investment const> investments) -> CashFlows
+{
+    if (model.eurPerUsd.empty())
+    {
+        throw std::invalid_argument{"cash-flow model needs at least one EUR/USD exchange rate"};
+    }
+
+    auto const n       = investments.size();
+    auto const years   = std::max(model.years, 0);
+    auto const columns = Columns{investments};
+    auto const tax     = model.taxRate.numerical_value_in(one);
+    auto const growth  = 1.0 + model.discountRate.numerical_value_in(one);
+
+    auto const exchange = [&](int year) {
+        auto const index = std::min(static_cast<std::size_t>(year), model.eurPerUsd.size()) - 1;
+        return model.eurPerUsd[index].numerical_value_in(finance::euro / finance::us_dollar);
+    };
+
+    auto result = CashFlows{
+        .scenarios = n,
+        .flows     = std::vector<double>((static_cast<std::size_t>(years) + 1) * n),
+        .npv       = std::vector<quantity<finance::euro>>(n),
+        .irr       = std::vector<quantity<percent>>(n),
+        .payback   = std::vector<int>(n, -1),
+    };
+
+    auto const blocks = (n + blockSize - 1) / blockSize;
+    parallelFor(
+        blocks,
+        [&](std::size_t block) {
+            auto const first = block * blockSize;
+            auto const count = std::min(blockSize, n - first);
+
+            auto npv   = std::array<double, blockSize>{};
+            auto sum   = std::array<double, blockSize>{};
+            auto lo    = std::array<double, blockSize>{};
+            auto hi    = std::array<double, blockSize>{};
+            auto mid   = std::array<double, blockSize>{};
+            auto atLo  = std::array<double, blockSize>{};
+            auto atHi  = std::array<double, blockSize>{};
+            auto atMid = std::array<double, blockSize>{};
+
+            auto* row = result.flows.data() + first;
+            for (auto i = std::size_t{0}; i < count; ++i)
+            {
+                row[i] = -columns.initial[first + i];
+                npv[i] = row[i];
+                sum[i] = row[i];
+            }
+
+            auto discount = 1.0;
+            for (auto y = 1; y <= years; ++y)
+            {
+                auto const rate = exchange(y);
+                discount /= growth;
+
+                row = result.flows.data() + static_cast<std::size_t>(y) * n + first;
+                for (auto i = std::size_t{0}; i < count; ++i)
+                {
+                    auto const s         = first + i;
+                    auto const operating = columns.revenue[s] - columns.opex[s] - columns.seeds[s] * rate;
+                    auto const taxes     = std::max(operating - columns.depreciation[s], 0.0) * tax;
+
+                    auto replacement = 0.0;
+                    for (auto a = std::size_t{0}; a < 3; ++a)
+                    {
+                        auto const life = columns.life[a][s];
+                        if (life > 0 && y < years && y % life == 0) { replacement += columns.price[a][s]; }
+                    }
+
+                    row[i] = operating - taxes - replacement;
+                    npv[i] += row[i] * discount;
+                    sum[i] += row[i];
+                    if (sum[i] >= 0.0 && result.payback[s] < 0) { result.payback[s] = y; }
+                }
+            }
+
+            std::fill_n(lo.begin(), count, irrLow);
+            std::fill_n(hi.begin(), count, irrHigh);
+            presentValues(result, years, first, count, lo.data(), atLo.data());
+            presentValues(result, years, first, count, hi.data(), atHi.data());
+
+            auto bracketed = std::array<bool, blockSize>{};
+            for (auto i = std::size_t{0}; i < count; ++i) { bracketed[i] = (atLo[i] > 0.0) != (atHi[i] > 0.0); }
+
+            for (auto iteration = 0; iteration < irrIterations; ++iteration)
+            {
+                for (auto i = std::size_t{0}; i < count; ++i) { mid[i] = 0.5 * (lo[i] + hi[i]); }
+                presentValues(result, years, first, count, mid.data(), atMid.data());
+                for (auto i = std::size_t{0}; i < count; ++i)
+                {
+                    auto const sameSide = (atMid[i] > 0.0) == (atLo[i] > 0.0);
+                    lo[i]               = sameSide ? mid[i] : lo[i];
+                    atLo[i]             = sameSide ? atMid[i] : atLo[i];
+                    hi[i]               = sameSide ? hi[i] : mid[i];
+                }
+            }
+
+            for (auto i = std::size_t{0}; i < count; ++i)
+            {
+                auto const irr        = bracketed[i] ? 0.5 * (lo[i] + hi[i]) : std::numeric_limits<double>::quiet_NaN();
+                result.npv[first + i] = npv[i] * finance::euro;
+                result.irr[first + i] = 100.0 * irr * percent;
+            }
+        },
+        1);
+
+    return result;
+}
+
+auto report(CashFlowModel const& model, CashFlows const& cashFlows) -> void
+{
+    using namespace finance::unit_symbols;
+
+    auto const n = cashFlows.scenarios;
+
+    fmt::println("Cash-Flow:");
+    fmt::println("---------");
+    fmt::println("Scenarios:     {}", n);
+    fmt::println("Years:         {}", model.years);
+    fmt::println("Discount-Rate: {}", model.discountRate);
+    fmt::println("Tax-Rate:      {}\n", model.taxRate);
+
+    if (n == 0) { return; }
+
+    auto const best     = std::ranges::max_element(cashFlows.npv) - cashFlows.npv.begin();
+    auto const positive = std::ranges::count_if(cashFlows.npv, [](auto npv) { return npv > 0.0 * EUR; });
+
+    auto total = 0.0 * EUR;
+    for (auto const& npv : cashFlows.npv) { total += npv; }
+
+    auto irr = std::vector<double>{};
+    for (auto const& rate : cashFlows.irr)
+    {
+        if (!std::isnan(rate.numerical_value_in(percent))) { irr.push_back(rate.numerical_value_in(percent)); }
+    }
+
+    fmt::println("NPV-Mean:      {::N[.2f]}", (total / static_cast<double>(n)).in(EUR));
+    fmt::println("NPV-Best:      {::N[.2f]} (#{})", cashFlows.npv[static_cast<std::size_t>(best)].in(EUR), best);
+    fmt::println("NPV-Positive:  {} of {}", positive, n);
+    if (!irr.empty())
+    {
+        auto const median = irr.begin() + static_cast<std::ptrdiff_t>(irr.size() / 2);
+        std::nth_element(irr.begin(), median, irr.end());
+        fmt::println("IRR-Median:    {::N[.2f]}", *median * percent);
+    }
+    fmt::println("");
+}
+
+}  // namespace tug
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Finance.hpp"
+
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+struct Asset
+{
+    quantity<finance::euro> capex;
+    int life;  // [years], bought again at the end of its life and depreciated straight-line
+};
+
+// One container investment, running costs per year
+struct Investment
+{
+    Asset container;
+    Asset lights;
+    Asset panels;
+
+    quantity<finance::euro> revenue;
+    quantity<finance::euro> opex;        // energy, rent, labour
+    quantity<finance::us_dollar> seeds;  // bought in USD at the rate of the year
+};
+
+struct CashFlowModel
+{
+    int years;
+    quantity<percent> discountRate;
+    quantity<percent> taxRate;  // on profit after depreciation, losses are not carried forward
+
+    // per year from year 1 on, the last rate holds for the rest of the horizon, at least one
+    std::vector<quantity<finance::euro / finance::us_dollar>> eurPerUsd;
+};
+
+struct CashFlows
+{
+    std::size_t scenarios;
+    std::vector<double> flows;  // [EUR], year-major: flows[year * scenarios + scenario], year 0 is the capex
+
+    std::vector<quantity<finance::euro>> npv;
+    // NaN unless the NPV changes sign between -99 % and 1000 %: the flows never
+    // change sign, change it an even number of times or the root lies outside
+    std::vector<quantity<percent>> irr;
+    std::vector<int> payback;  // first year the cumulated cash flow is >= 0, -1 if never
+
+    [[nodiscard]] auto flow(std::size_t scenario, int year) const -> quantity<finance::euro>
+    {
+        return flows[static_cast<std::size_t>(year) * scenarios + scenario] * finance::euro;
+    }
+};
+
+// Evaluates all scenarios at once: the inputs are unpacked into one array per
+// field, every year is a pass over contiguous arrays, and IRR is found by a
+// fixed number of bisection steps for all scenarios side by side. Blocks of
+// scenarios run in parallel.
+//
+// Throws std::invalid_argument if the model has no exchange rate.
+[[nodiscard]] auto evaluateCashFlows(CashFlowModel const& model, std::span<Investment const> investments)
+    -> CashFlows;
+
+auto report(CashFlowModel const& model, CashFlows const& cashFlows) -> void;
+
+}  // namespace tug
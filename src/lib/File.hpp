@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+
+namespace tug
+{
+
+struct FileClose
+{
+    auto operator()(std::FILE* file) const noexcept -> void { std::fclose(file); }
+};
+
+// Owning std::FILE handle, closed on scope exit. Callers that need to see a
+// failed close release() it and call std::fclose() themselves.
+using File = std::unique_ptr<std::FILE, FileClose>;
+
+}  // namespace tug
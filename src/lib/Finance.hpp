@@ -8,6 +8,8 @@ namespace tug
 namespace finance
 {
 
+using mp_units::quantity;
+
 // clang-format off
 inline constexpr struct dim_currency : mp_units::base_dimension<"$"> {} dim_currency;
 inline constexpr struct currency : mp_units::quantity_spec<currency, dim_currency> {} currency;
@@ -24,6 +26,11 @@ inline constexpr auto USD = us_dollar;
 
 }  // namespace unit_symbols
 
+[[nodiscard]] constexpr auto toEuro(quantity<us_dollar> amount, quantity<euro / us_dollar> rate) -> quantity<euro>
+{
+    return amount.numerical_value_in(us_dollar) * rate.numerical_value_in(euro / us_dollar) * euro;
+}
+
 }  // namespace finance
 
 }  // namespace tug
@@ -0,0 +1,386 @@
+#include "Fleet.hpp"
+
+#include "Parallel.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace tug
+{
+
+namespace
+{
+
+constexpr auto npos       = std::numeric_limits<std::size_t>::max();
+constexpr auto infeasible = std::numeric_limits<double>::infinity();
+constexpr auto minGain    = 1.0;  // [J], keeps local search from chasing rounding noise
+constexpr auto maxPartner = std::size_t{64};  // swap partners tried per candidate, keeps a round near linear
+
+// Per airframe max-heap of the remaining shift time of its drones. Entries go
+// stale when a drone's load changes, update() pushes the fresh value and stale
+// entries are dropped lazily when they reach the top.
+class Capacity
+{
+public:
+    Capacity(Fleet const& fleet, std::vector<double> const& busy, double shift)
+        : _drones{fleet.drones}
+        , _busy{busy}
+        , _shift{shift}
+        , _heaps(fleet.airframes.size())
+    {
+        for (auto drone = std::size_t{0}; drone < _drones.size(); ++drone) { update(drone); }
+    }
+
+    [[nodiscard]] auto find(std::size_t airframe, double duration) -> std::optional<std::size_t>
+    {
+        auto& heap = _heaps[airframe];
+        while (!heap.empty())
+        {
+            auto const [left, drone] = heap.top();
+            if (left != remaining(drone))
+            {
+                heap.pop();
+                continue;
+            }
+            if (left < duration) { return std::nullopt; }
+            return drone;
+        }
+        return std::nullopt;
+    }
+
+    auto update(std::size_t drone) -> void { _heaps[_drones[drone]].emplace(remaining(drone), drone); }
+
+private:
+    [[nodiscard]] auto remaining(std::size_t drone) const noexcept -> double { return _shift - _busy[drone]; }
+
+    std::vector<std::size_t> const& _drones;
+    std::vector<double> const& _busy;
+    double _shift;
+    std::vector<std::priority_queue<std::pair<double, std::size_t>>> _heaps;
+};
+
+}  // namespace
+
+FleetPlanner::FleetPlanner(Fleet fleet)
+    : _fleet{std::move(fleet)}
+    , _shift{_fleet.shift.numerical_value_in(si::second)}
+    , _busy(_fleet.drones.size(), 0.0)
+{
+}
+
+auto FleetPlanner::add(std::span<Delivery const> deliveries) -> void
+{
+    auto const airframes = _fleet.airframes.size();
+    auto const first     = this->deliveries();
+    auto const last      = first + deliveries.size();
+
+    _energy.resize(last * airframes);
+    _duration.resize(last * airframes);
+    _assignment.resize(last, npos);
+
+    parallelFor(deliveries.size(), [&](std::size_t i) {
+        auto const& delivery = deliveries[i];
+        auto const legTime   = (delivery.leg.distance / delivery.leg.speed).numerical_value_in(si::second);
+
+        for (auto a = std::size_t{0}; a < airframes; ++a)
+        {
+            auto const& airframe = _fleet.airframes[a];
+            auto const idx       = cell(first + i, a);
+
+            _energy[idx]   = infeasible;
+            _duration[idx] = infeasible;
+            if (delivery.payload > airframe.maxPayload) { continue; }
+
+            auto loaded = airframe.copter;
+            loaded.weight += delivery.payload;
+
+            auto const outbound = estimateFlightEnergy(loaded, delivery.leg).numerical_value_in(si::joule);
+            auto const inbound  = estimateFlightEnergy(airframe.copter, delivery.leg).numerical_value_in(si::joule);
+            auto const usable   = airframe.battery.numerical_value_in(si::joule)
+                              * (1.0 - airframe.reserve.numerical_value_in(one));
+            if (outbound + inbound > usable) { continue; }
+
+            auto const recharge = (outbound + inbound) / airframe.charger.numerical_value_in(si::watt);
+            _energy[idx]        = outbound + inbound;
+            _duration[idx]      = 2.0 * legTime + recharge;
+        }
+    });
+
+    auto const order = byRegret(first, last);
+    insert(order);
+}
+
+auto FleetPlanner::optimize(std::size_t maxRounds) -> void
+{
+    for (auto round = std::size_t{0}; round < maxRounds; ++round)
+    {
+        auto moves = improve();
+
+        // capacity freed by the moves above may fit orders that were left out
+        auto const order = byRegret(0, deliveries());
+        moves += insert(order);
+
+        if (moves == 0) { break; }
+    }
+}
+
+auto FleetPlanner::assignment(std::size_t delivery) const -> std::optional<std::size_t>
+{
+    if (_assignment[delivery] == npos) { return std::nullopt; }
+    return _assignment[delivery];
+}
+
+auto FleetPlanner::unassigned() const -> std::size_t
+{
+    return static_cast<std::size_t>(std::ranges::count(_assignment, npos));
+}
+
+auto FleetPlanner::energy() const -> quantity<isq::energy[si::joule]>
+{
+    auto total = 0.0;
+    for (auto d = std::size_t{0}; d < deliveries(); ++d)
+    {
+        if (_assignment[d] != npos) { total += _energy[cell(d, airframeOf(d))]; }
+    }
+    return total * si::joule;
+}
+
+auto FleetPlanner::busy(std::size_t drone) const -> quantity<isq::time[si::second]>
+{
+    return _busy[drone] * si::second;
+}
+
+auto FleetPlanner::cell(std::size_t delivery, std::size_t airframe) const noexcept -> std::size_t
+{
+    return delivery * _fleet.airframes.size() + airframe;
+}
+
+auto FleetPlanner::airframeOf(std::size_t delivery) const noexcept -> std::size_t
+{
+    return _fleet.drones[_assignment[delivery]];
+}
+
+// Unassigned deliveries in [first, last) that at least one airframe can fly,
+// ordered by the energy difference between their best and second best airframe.
+// Orders with few good options are placed before the cheap drones run full.
+auto FleetPlanner::byRegret(std::size_t first, std::size_t last) const -> std::vector<std::size_t>
+{
+    auto const airframes = _fleet.airframes.size();
+
+    auto regret = std::vector<double>(last - first, -1.0);
+    parallelFor(last - first, [&](std::size_t i) {
+        if (_assignment[first + i] != npos) { return; }
+
+        auto best   = infeasible;
+        auto second = infeasible;
+        for (auto a = std::size_t{0}; a < airframes; ++a)
+        {
+            auto const e = _energy[cell(first + i, a)];
+            if (e < best) { second = std::exchange(best, e); }
+            else if (e < second) { second = e; }
+        }
+        if (best != infeasible) { regret[i] = second - best; }
+    });
+
+    auto order = std::vector<std::size_t>{};
+    for (auto i = std::size_t{0}; i < regret.size(); ++i)
+    {
+        if (regret[i] >= 0.0) { order.push_back(first + i); }
+    }
+    std::ranges::stable_sort(order, std::ranges::greater{}, [&](auto d) { return regret[d - first]; });
+    return order;
+}
+
+auto FleetPlanner::assign(std::size_t delivery, std::size_t drone) -> void
+{
+    _assignment[delivery] = drone;
+    _busy[drone] += _duration[cell(delivery, _fleet.drones[drone])];
+}
+
+auto FleetPlanner::unassign(std::size_t delivery) -> void
+{
+    _busy[_assignment[delivery]] -= _duration[cell(delivery, airframeOf(delivery))];
+    _assignment[delivery] = npos;
+}
+
+// Greedy: every delivery goes to the cheapest airframe that still has a drone
+// with enough shift time left, picking the least loaded drone of that type.
+auto FleetPlanner::insert(std::span<std::size_t const> order) -> std::size_t
+{
+    auto capacity  = Capacity{_fleet, _busy, _shift};
+    auto airframes = std::vector<std::size_t>(_fleet.airframes.size());
+    auto inserted  = std::size_t{0};
+
+    for (auto delivery : order)
+    {
+        std::iota(airframes.begin(), airframes.end(), std::size_t{0});
+        std::ranges::sort(airframes, std::ranges::less{}, [&](auto a) { return _energy[cell(delivery, a)]; });
+
+        for (auto a : airframes)
+        {
+            if (_energy[cell(delivery, a)] == infeasible) { break; }
+            if (auto drone = capacity.find(a, _duration[cell(delivery, a)]))
+            {
+                assign(delivery, *drone);
+                capacity.update(*drone);
+                ++inserted;
+                break;
+            }
+        }
+    }
+
+    return inserted;
+}
+
+// One round of local search. The cheapest other airframe of every assigned
+// delivery is found in parallel, the moves are then applied sequentially,
+// largest gain first: relocate if a drone of that airframe has time left,
+// otherwise swap with a delivery on that airframe if both drones stay in shift.
+// An earlier move may have changed a candidate's airframe, so the gain is
+// checked again before it is applied. Swap partners are tried round robin,
+// at most maxPartner per candidate.
+auto FleetPlanner::improve() -> std::size_t
+{
+    auto const airframes = _fleet.airframes.size();
+    auto const count     = deliveries();
+
+    auto target = std::vector<std::size_t>(count, npos);
+    auto gain   = std::vector<double>(count, 0.0);
+    parallelFor(count, [&](std::size_t d) {
+        if (_assignment[d] == npos) { return; }
+
+        auto const current = _energy[cell(d, airframeOf(d))];
+        for (auto a = std::size_t{0}; a < airframes; ++a)
+        {
+            auto const saved = current - _energy[cell(d, a)];
+            if (saved > std::max(gain[d], minGain))
+            {
+                target[d] = a;
+                gain[d]   = saved;
+            }
+        }
+    });
+
+    // assigned deliveries per airframe, position[d] is d's index in its list
+    auto candidates = std::vector<std::size_t>{};
+    auto members    = std::vector<std::vector<std::size_t>>(airframes);
+    auto position   = std::vector<std::size_t>(count, npos);
+    for (auto d = std::size_t{0}; d < count; ++d)
+    {
+        if (target[d] != npos) { candidates.push_back(d); }
+        if (_assignment[d] == npos) { continue; }
+
+        auto& list  = members[airframeOf(d)];
+        position[d] = list.size();
+        list.push_back(d);
+    }
+    std::ranges::stable_sort(candidates, std::ranges::greater{}, [&](auto d) { return gain[d]; });
+
+    auto const relink = [&](std::size_t d, std::size_t from, std::size_t to) {
+        auto& list            = members[from];
+        list[position[d]]     = list.back();
+        position[list.back()] = position[d];
+        list.pop_back();
+
+        position[d] = members[to].size();
+        members[to].push_back(d);
+    };
+
+    auto capacity = Capacity{_fleet, _busy, _shift};
+    auto cursor   = std::vector<std::size_t>(airframes, 0);
+    auto moves    = std::size_t{0};
+
+    for (auto d : candidates)
+    {
+        auto const from = airframeOf(d);
+        auto const to   = target[d];
+        if (from == to || !(_energy[cell(d, from)] - _energy[cell(d, to)] > minGain)) { continue; }
+
+        auto const mine = _assignment[d];
+        if (auto drone = capacity.find(to, _duration[cell(d, to)]))
+        {
+            unassign(d);
+            assign(d, *drone);
+            capacity.update(mine);
+            capacity.update(*drone);
+            relink(d, from, to);
+            ++moves;
+            continue;
+        }
+
+        auto const& list = members[to];
+        auto const tries = std::min(maxPartner, list.size());
+        auto partner     = npos;
+        for (auto k = std::size_t{0}; k < tries && partner == npos; ++k)
+        {
+            auto const other  = list[(cursor[to] + k) % list.size()];
+            auto const saved  = _energy[cell(d, from)] + _energy[cell(other, to)] - _energy[cell(d, to)]
+                              - _energy[cell(other, from)];
+            auto const theirs = _assignment[other];
+            if (!(saved > minGain)) { continue; }
+            if (_busy[mine] - _duration[cell(d, from)] + _duration[cell(other, from)] > _shift) { continue; }
+            if (_busy[theirs] - _duration[cell(other, to)] + _duration[cell(d, to)] > _shift) { continue; }
+
+            partner = other;
+        }
+        cursor[to] += tries;
+        if (partner == npos) { continue; }
+
+        auto const theirs = _assignment[partner];
+        unassign(d);
+        unassign(partner);
+        assign(d, theirs);
+        assign(partner, mine);
+        capacity.update(mine);
+        capacity.update(theirs);
+        relink(d, from, to);
+        relink(partner, to, from);
+        ++moves;
+    }
+
+    return moves;
+}
+
+auto report(FleetPlanner const& planner) -> void
+{
+    using namespace mp_units::si::unit_symbols;
+
+    auto const& fleet = planner.fleet();
+    auto const drones = fleet.drones.size();
+    auto const count  = planner.deliveries();
+    auto const missed = planner.unassigned();
+
+    quantity<isq::time[si::hour]> busy = 0.0 * h;
+    for (auto drone = std::size_t{0}; drone < drones; ++drone) { busy += planner.busy(drone); }
+
+    QuantityOf<isq::energy> auto energy = planner.energy();
+    QuantityOf<dimensionless> auto load = busy / (fleet.shift * static_cast<double>(drones));
+
+    fmt::println("Fleet:");
+    fmt::println("-----");
+    fmt::println("Airframes:   {}", fleet.airframes.size());
+    fmt::println("Drones:      {}", drones);
+    fmt::println("Shift:       {}\n", fleet.shift.in(h));
+
+    fmt::println("Deliveries:  {}", count);
+    fmt::println("Assigned:    {}", count - missed);
+    fmt::println("Unassigned:  {}\n", missed);
+
+    fmt::println("Energy:      {::N[.3f]}", energy.in(kW * h));
+    if (count != missed)
+    {
+        fmt::println("Energy/Trip: {::N[.3f]}", (energy / static_cast<double>(count - missed)).in(W * h));
+    }
+    fmt::println("Utilization: {::N[.2f]}", load.in(percent));
+    fmt::println("");
+}
+
+}  // namespace tug
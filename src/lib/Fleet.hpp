@@ -0,0 +1,83 @@
+#pragma once
+
+#include "QuadCopter.hpp"
+
+#include <mp-units/systems/isq.h>
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+struct Airframe
+{
+    std::string name;
+    QuadCopter copter;
+    quantity<isq::mass[si::kilogram]> maxPayload;
+    quantity<isq::energy[si::kilo<si::watt> * si::hour]> battery;
+    quantity<isq::power[si::watt]> charger;
+    quantity<percent> reserve;
+};
+
+struct Delivery
+{
+    Flight leg;  // depot to drop-off, the return leg is flown without payload
+    quantity<isq::mass[si::kilogram]> payload;
+};
+
+struct Fleet
+{
+    std::vector<Airframe> airframes;
+    std::vector<std::size_t> drones;  // airframe index per drone
+    quantity<isq::time[si::hour]> shift;
+};
+
+// Assigns deliveries to the drones of a fleet, minimizing the total flight
+// energy while every drone stays within its shift (flight + recharge time).
+//
+// The delivery x airframe energy matrix is computed once per delivery, so new
+// orders can be added at any time and only their rows are evaluated. add()
+// inserts the new orders greedily (highest regret first), optimize() then runs
+// relocate/swap local search over all orders.
+class FleetPlanner
+{
+public:
+    explicit FleetPlanner(Fleet fleet);
+
+    auto add(std::span<Delivery const> deliveries) -> void;
+    auto optimize(std::size_t maxRounds = 8) -> void;
+
+    [[nodiscard]] auto fleet() const noexcept -> Fleet const& { return _fleet; }
+    [[nodiscard]] auto deliveries() const noexcept -> std::size_t { return _assignment.size(); }
+    [[nodiscard]] auto assignment(std::size_t delivery) const -> std::optional<std::size_t>;
+    [[nodiscard]] auto unassigned() const -> std::size_t;
+    [[nodiscard]] auto energy() const -> quantity<isq::energy[si::joule]>;
+    [[nodiscard]] auto busy(std::size_t drone) const -> quantity<isq::time[si::second]>;
+
+private:
+    [[nodiscard]] auto cell(std::size_t delivery, std::size_t airframe) const noexcept -> std::size_t;
+    [[nodiscard]] auto airframeOf(std::size_t delivery) const noexcept -> std::size_t;
+    [[nodiscard]] auto byRegret(std::size_t first, std::size_t last) const -> std::vector<std::size_t>;
+    auto assign(std::size_t delivery, std::size_t drone) -> void;
+    auto unassign(std::size_t delivery) -> void;
+    auto insert(std::span<std::size_t const> order) -> std::size_t;
+    auto improve() -> std::size_t;
+
+    Fleet _fleet;
+    double _shift;                         // [s]
+    std::vector<double> _energy;           // delivery x airframe [J], infinity if infeasible
+    std::vector<double> _duration;         // delivery x airframe, flight + recharge [s]
+    std::vector<std::size_t> _assignment;  // drone per delivery
+    std::vector<double> _busy;             // per drone [s]
+};
+
+auto report(FleetPlanner const& planner) -> void;
+
+}  // namespace tug
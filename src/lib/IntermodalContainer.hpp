@@ -16,6 +16,33 @@ struct IntermodalContainer
 
     [[nodiscard]] constexpr auto area() const noexcept -> QuantityOf<isq::area> auto { return length * width; }
     [[nodiscard]] constexpr auto volume() const noexcept -> QuantityOf<isq::volume> auto { return area() * height; }
+
+    // Outer envelope for these inner dimensions, adds the ISO 668 steel walls,
+    // floor and roof. Exact for the presets below.
+    [[nodiscard]] constexpr auto outside() const noexcept -> IntermodalContainer
+    {
+        return {
+            .length = length + 0.160 * si::metre,
+            .width  = width + 0.086 * si::metre,
+            .height = height + 0.198 * si::metre,
+        };
+    }
+
+    // ISO 668 inner dimensions
+    [[nodiscard]] static constexpr auto standard20() noexcept -> IntermodalContainer
+    {
+        return {.length = 5.898 * si::metre, .width = 2.352 * si::metre, .height = 2.393 * si::metre};
+    }
+
+    [[nodiscard]] static constexpr auto standard40() noexcept -> IntermodalContainer
+    {
+        return {.length = 12.032 * si::metre, .width = 2.352 * si::metre, .height = 2.393 * si::metre};
+    }
+
+    [[nodiscard]] static constexpr auto highCube40() noexcept -> IntermodalContainer
+    {
+        return {.length = 12.032 * si::metre, .width = 2.352 * si::metre, .height = 2.698 * si::metre};
+    }
 };
 
 }  // namespace tug
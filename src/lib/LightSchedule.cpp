@@ -0,0 +1,274 @@
+#include "LightSchedule.hpp"
+
+#include "Parallel.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace tug
+{
+
+namespace
+{
+
+constexpr auto infinity = std::numeric_limits<double>::infinity();
+constexpr auto minCop   = 0.1;
+
+// The slots must cover exactly one day, the cop is per slot or empty (1.0)
+auto validate(DayAheadPrices const& prices) -> void
+{
+    auto const slot = prices.slot.numerical_value_in(si::minute);
+    if (!(slot > 0.0)) { throw std::invalid_argument{"day-ahead prices need a positive slot length"}; }
+    if (std::abs(slot * static_cast<double>(prices.price.size()) - 24.0 * 60.0) > 1e-6)
+    {
+        throw std::invalid_argument{"day-ahead prices must cover exactly one day"};
+    }
+    if (!prices.cop.empty() && prices.cop.size() != prices.price.size())
+    {
+        throw std::invalid_argument{"day-ahead prices need one cop per price slot"};
+    }
+}
+
+// Price and energy of one lit shelf per slot, lights plus air conditioning
+struct ShelfCost
+{
+    std::vector<double> price;   // [EUR]
+    std::vector<double> energy;  // [kWh]
+};
+
+[[nodiscard]] auto shelfCost(GrowContainer const& gc, DayAheadPrices const& prices) -> ShelfCost
+{
+    using namespace mp_units::si::unit_symbols;
+    using namespace finance::unit_symbols;
+
+    auto const hours  = prices.slot.numerical_value_in(h);
+    auto const lights = gc.lightsPerShelf.numerical_value_in(one);
+    auto const power  = gc.light.power.numerical_value_in(kW) * lights;
+    auto const waste  = gc.light.waste().numerical_value_in(kW) * lights;
+
+    auto cost = ShelfCost{.price = std::vector<double>(prices.price.size()), .energy = {}};
+    cost.energy.resize(prices.price.size());
+    for (auto t = std::size_t{0}; t < prices.price.size(); ++t)
+    {
+        auto const cop = !prices.cop.empty() ? std::max(prices.cop[t].numerical_value_in(one), minCop) : 1.0;
+        cost.energy[t] = (power + waste / cop) * hours;
+        cost.price[t]  = cost.energy[t] * prices.price[t].numerical_value_in(EUR / (kW * h));
+    }
+    return cost;
+}
+
+[[nodiscard]] auto slotsNeeded(Microgreen const& crop, DayAheadPrices const& prices) -> std::size_t
+{
+    auto const minutes = (crop.light * (1.0 * si::day)).numerical_value_in(si::minute);
+    auto const slots   = std::ceil(minutes / prices.slot.numerical_value_in(si::minute) - 1e-9);
+    return static_cast<std::size_t>(std::max(slots, 0.0));
+}
+
+auto validate(Microgreen const& crop, DayAheadPrices const& prices) -> void
+{
+    if (slotsNeeded(crop, prices) > prices.price.size())
+    {
+        throw std::invalid_argument{"crop needs more light than there is in a day"};
+    }
+}
+
+// Picks exactly `lit` slots forming at most `maxBlocks` runs at the lowest
+// summed cost. State after each slot: lit slots so far, runs started so far
+// and whether the slot itself is lit. A run over midnight counts as two.
+// More runs than lit slots can't be used, so maxBlocks is clamped to `lit`.
+[[nodiscard]] auto cheapestSlots(std::span<double const> cost, std::size_t lit, std::size_t maxBlocks)
+    -> std::vector<bool>
+{
+    auto const slots = cost.size();
+    auto on          = std::vector<bool>(slots, false);
+
+    if (lit == 0) { return on; }
+    maxBlocks = std::clamp<std::size_t>(maxBlocks, 1, lit);
+
+    auto const states = (lit + 1) * (maxBlocks + 1) * 2;
+    auto const state  = [&](std::size_t j, std::size_t b, std::size_t lamp) {
+        return (j * (maxBlocks + 1) + b) * 2 + lamp;
+    };
+
+    auto dp   = std::vector<double>(states, infinity);
+    auto next = std::vector<double>(states);
+    auto from = std::vector<std::uint32_t>(slots * states);
+
+    dp[state(0, 0, 0)] = 0.0;
+
+    for (auto t = std::size_t{0}; t < slots; ++t)
+    {
+        std::ranges::fill(next, infinity);
+        auto* predecessor = from.data() + t * states;
+
+        auto const relax = [&](std::size_t to, double value, std::size_t source) {
+            if (value < next[to])
+            {
+                next[to]        = value;
+                predecessor[to] = static_cast<std::uint32_t>(source);
+            }
+        };
+
+        for (auto j = std::size_t{0}; j <= lit; ++j)
+        {
+            for (auto b = std::size_t{0}; b <= maxBlocks; ++b)
+            {
+                for (auto lamp = std::size_t{0}; lamp < 2; ++lamp)
+                {
+                    auto const s = state(j, b, lamp);
+                    if (dp[s] == infinity) { continue; }
+
+                    relax(state(j, b, 0), dp[s], s);
+
+                    auto const blocks = lamp == 1 ? b : b + 1;
+                    if (j < lit && blocks <= maxBlocks) { relax(state(j + 1, blocks, 1), dp[s] + cost[t], s); }
+                }
+            }
+        }
+        std::swap(dp, next);
+    }
+
+    auto best = state(lit, 0, 0);
+    for (auto b = std::size_t{0}; b <= maxBlocks; ++b)
+    {
+        for (auto lamp = std::size_t{0}; lamp < 2; ++lamp)
+        {
+            if (dp[state(lit, b, lamp)] < dp[best]) { best = state(lit, b, lamp); }
+        }
+    }
+
+    for (auto t = slots; t-- > 0;)
+    {
+        on[t] = best % 2 == 1;
+        best  = from[t * states + best];
+    }
+    return on;
+}
+
+[[nodiscard]] auto makeSchedule(ShelfCost const& cost, std::vector<bool> on) -> LightSchedule
+{
+    auto energy = 0.0;
+    auto price  = 0.0;
+    for (auto t = std::size_t{0}; t < on.size(); ++t)
+    {
+        if (!on[t]) { continue; }
+        energy += cost.energy[t];
+        price += cost.price[t];
+    }
+
+    return LightSchedule{
+        .on     = std::move(on),
+        .energy = energy * si::kilo<si::watt> * si::hour,
+        .cost   = price * finance::euro,
+    };
+}
+
+}  // namespace
+
+auto scheduleShelf(GrowContainer const& gc, Microgreen const& crop, DayAheadPrices const& prices,
+                   std::size_t maxBlocks) -> LightSchedule
+{
+    validate(prices);
+    validate(crop, prices);
+
+    auto const cost = shelfCost(gc, prices);
+    return makeSchedule(cost, cheapestSlots(cost.price, slotsNeeded(crop, prices), maxBlocks));
+}
+
+auto scheduleFleet(std::span<LightingJob const> jobs, DayAheadPrices const& prices, std::size_t maxBlocks)
+    -> std::vector<ContainerSchedule>
+{
+    validate(prices);
+    for (auto const& job : jobs)
+    {
+        if (job.crops.size() > static_cast<std::size_t>(job.container.shelfs().numerical_value_in(one)))
+        {
+            throw std::invalid_argument{"lighting job has more crops than its container has shelfs"};
+        }
+        for (auto const& crop : job.crops) { validate(crop, prices); }
+    }
+
+    auto result = std::vector<ContainerSchedule>(jobs.size());
+    parallelFor(
+        jobs.size(),
+        [&](std::size_t c) {
+            auto const& job = jobs[c];
+            auto const cost = shelfCost(job.container, prices);
+
+            auto solved   = std::map<std::size_t, LightSchedule>{};
+            auto schedule = ContainerSchedule{
+                .shelfs = {},
+                .energy = 0.0 * si::kilo<si::watt> * si::hour,
+                .cost   = 0.0 * finance::euro,
+            };
+            for (auto const& crop : job.crops)
+            {
+                auto const lit = slotsNeeded(crop, prices);
+                auto found     = solved.find(lit);
+                if (found == solved.end())
+                {
+                    found = solved.emplace(lit, makeSchedule(cost, cheapestSlots(cost.price, lit, maxBlocks))).first;
+                }
+
+                schedule.shelfs.push_back(found->second);
+                schedule.energy += found->second.energy;
+                schedule.cost += found->second.cost;
+            }
+            result[c] = std::move(schedule);
+        },
+        1);
+
+    return result;
+}
+
+auto report(ContainerSchedule const& schedule, DayAheadPrices const& prices) -> void
+{
+    using namespace mp_units::si::unit_symbols;
+    using namespace finance::unit_symbols;
+
+    auto const slot  = prices.slot.numerical_value_in(min);
+    auto const clock = [&](std::size_t t) {
+        auto const minutes = static_cast<int>(std::lround(static_cast<double>(t) * slot));
+        return fmt::format("{:02}:{:02}", minutes / 60, minutes % 60);
+    };
+
+    fmt::println("Light-Schedule:");
+    fmt::println("--------------");
+    fmt::println("Slot:        {}", prices.slot);
+    fmt::println("Shelfs:      {}", schedule.shelfs.size());
+    fmt::println("Energy:      {::N[.2f]}", schedule.energy.in(kW * h));
+    fmt::println("Energy-Cost: {::N[.2f]}", schedule.cost.in(EUR));
+    if (schedule.energy > 0.0 * kW * h)
+    {
+        fmt::println("Avg-Price:   {::N[.3f]}", (schedule.cost / schedule.energy).in(EUR / (kW * h)));
+    }
+    fmt::println("");
+
+    for (auto s = std::size_t{0}; s < schedule.shelfs.size(); ++s)
+    {
+        auto const& on = schedule.shelfs[s].on;
+        auto blocks    = std::string{};
+        for (auto t = std::size_t{0}; t < on.size(); ++t)
+        {
+            if (!on[t] || (t > 0 && on[t - 1])) { continue; }
+
+            auto end = t;
+            while (end < on.size() && on[end]) { ++end; }
+            blocks += fmt::format("{}{}-{}", blocks.empty() ? "" : ", ", clock(t), clock(end));
+        }
+        fmt::println("Shelf-{}: {}", s, blocks);
+    }
+    fmt::println("");
+}
+
+}  // namespace tug
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Finance.hpp"
+#include "Microgreens.hpp"
+
+#include <mp-units/systems/isq.h>
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+struct DayAheadPrices
+{
+    quantity<isq::time[si::minute]> slot;  // 60 or 15 min
+    std::vector<quantity<finance::euro / (si::kilo<si::watt> * si::hour)>> price;
+    std::vector<quantity<one>> cop;  // coefficient of performance of the air conditioning, higher in the cool night
+};
+
+struct LightSchedule
+{
+    std::vector<bool> on;  // per slot
+    quantity<isq::energy[si::kilo<si::watt> * si::hour]> energy;
+    quantity<finance::euro> cost;
+};
+
+struct ContainerSchedule
+{
+    std::vector<LightSchedule> shelfs;
+    quantity<isq::energy[si::kilo<si::watt> * si::hour]> energy;
+    quantity<finance::euro> cost;
+};
+
+// One container of the fleet, crops[i] grows on shelf i, extra shelfs stay dark.
+// At most one crop per shelf.
+struct LightingJob
+{
+    GrowContainer container;
+    std::vector<Microgreen> crops;
+};
+
+// Cheapest day for one shelf: exactly the light hours the crop needs, in at
+// most `maxBlocks` on-periods, paying lights plus the cooling for their waste
+// heat at every slot's price. Dynamic program over (slot, lit slots, blocks).
+//
+// Throws std::invalid_argument if the slots aren't positive or don't cover
+// exactly one day, the cop isn't empty or one per slot, or the crop needs
+// more light than a day has.
+[[nodiscard]] auto scheduleShelf(GrowContainer const& gc, Microgreen const& crop, DayAheadPrices const& prices,
+                                 std::size_t maxBlocks) -> LightSchedule;
+
+// Schedules every shelf of every container, containers in parallel. Shelfs
+// needing the same light hours share one solution.
+//
+// Validates all jobs before scheduling any, throws like scheduleShelf() and
+// for a job with more crops than its container has shelfs.
+[[nodiscard]] auto scheduleFleet(std::span<LightingJob const> jobs, DayAheadPrices const& prices,
+                                 std::size_t maxBlocks) -> std::vector<ContainerSchedule>;
+
+auto report(ContainerSchedule const& schedule, DayAheadPrices const& prices) -> void;
+
+}  // namespace tug
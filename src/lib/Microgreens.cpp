@@ -13,7 +13,15 @@
 namespace tug
 {
 
-auto loadMicrogreens(std::filesystem::path const& path) -> std::vector<Microgreen>
+namespace
+{
+
+constexpr auto trayArea = (10.0 * international::inch) * (20.0 * international::inch);  // 1020 tray
+
+}  // namespace
+
+auto loadMicrogreens(std::filesystem::path const& path, quantity<finance::euro / finance::us_dollar> eurPerUsd)
+    -> std::vector<Microgreen>
 {
     auto file = std::ifstream{path};
 
@@ -37,7 +45,6 @@ auto loadMicrogreens(std::filesystem::path const& path) -> std::vector<Microgree
 
         // seeds / tray
         std::getline(ss, token, ',');
-        auto const trayArea     = (10.0 * international::inch) * (20.0 * international::inch);
         auto const seedsPerTray = std::stod(token) * si::gram / trayArea;
 
         // yield / tray
@@ -50,7 +57,8 @@ auto loadMicrogreens(std::filesystem::path const& path) -> std::vector<Microgree
 
         // seed-price / 25lb
         std::getline(ss, token, ',');
-        auto const seedPrice = std::stod(token) * finance::euro / (25.0 * international::pound);
+        auto const bagPrice  = finance::toEuro(std::stod(token) * finance::us_dollar, eurPerUsd);
+        auto const seedPrice = bagPrice / (25.0 * international::pound);
 
         result.push_back(Microgreen{
             .name = name,
@@ -72,6 +80,30 @@ auto loadMicrogreens(std::filesystem::path const& path) -> std::vector<Microgree
     return result;
 }
 
+auto trayEconomics(Microgreen const& plant) -> TrayEconomics
+{
+    QuantityOf<isq::mass> auto seeds         = plant.seeds * trayArea;
+    QuantityOf<finance::currency> auto price = seeds * plant.price;
+    QuantityOf<finance::currency> auto value = plant.msrp * plant.yield;
+    QuantityOf<dimensionless> auto cycles    = 30.0 * si::day / plant.grow;
+
+    return TrayEconomics{
+        .seeds  = seeds,
+        .price  = price,
+        .value  = value,
+        .cycles = cycles,
+    };
+}
+
+auto coolingPower(GrowContainer const& gc) -> quantity<isq::power[si::watt]>
+{
+    using namespace mp_units::si::unit_symbols;
+
+    QuantityOf<isq::time> auto lightTime                    = (1.0 * h).in(s);
+    QuantityOf<isq::thermodynamic_temperature> auto delta_T = gc.heat() * lightTime;
+    return airConditionPower(gc.container.volume(), delta_T, lightTime);
+}
+
 auto report(GrowContainer const& gc) -> void
 {
     using namespace mp_units::si::unit_symbols;
@@ -79,7 +111,7 @@ auto report(GrowContainer const& gc) -> void
 
     QuantityOf<isq::time> auto lightTime                    = (1.0 * h).in(s);
     QuantityOf<isq::thermodynamic_temperature> auto delta_T = gc.heat() * lightTime;
-    QuantityOf<isq::power> auto cooling                  = airConditionPower(gc.container.volume(), delta_T, lightTime);
+    QuantityOf<isq::power> auto cooling                  = coolingPower(gc);
     QuantityOf<isq::power> auto totalPower               = gc.powerLights() + cooling;
     QuantityOf<isq::energy / isq::time> auto totalEnergy = totalPower * 8 * h / d;
 
@@ -118,12 +150,12 @@ auto report(GrowContainer const& gc, Microgreen const& plant) -> void
     using namespace mp_units::si::unit_symbols;
     using namespace finance::unit_symbols;
 
-    QuantityOf<isq::area> auto trayArea      = (10.0 * international::inch) * (20.0 * international::inch);
-    QuantityOf<isq::mass> auto seeds         = plant.seeds * trayArea;
-    QuantityOf<finance::currency> auto price = seeds * plant.price;
-    QuantityOf<finance::currency> auto value = plant.msrp * plant.yield;
-    QuantityOf<isq::time> auto cycle         = plant.germination + plant.grow + plant.rest;
-    QuantityOf<dimensionless> auto cycles    = 30.0 * d / plant.grow;
+    auto const tray                  = trayEconomics(plant);
+    auto const seeds                 = tray.seeds;
+    auto const price                 = tray.price;
+    auto const value                 = tray.value;
+    auto const cycles                = tray.cycles;
+    QuantityOf<isq::time> auto cycle = plant.germination + plant.grow + plant.rest;
 
     fmt::println("Microgreens-Tray(1020):");
     fmt::println("----------------------");
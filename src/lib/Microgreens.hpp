@@ -33,7 +33,22 @@ struct Microgreen
     quantity<finance::euro / si::kilogram> msrp;
 };
 
-[[nodiscard]] auto loadMicrogreens(std::filesystem::path const& path) -> std::vector<Microgreen>;
+// One 1020 tray (10 x 20 inch) of a crop
+struct TrayEconomics
+{
+    quantity<isq::mass[si::gram]> seeds;
+    quantity<finance::euro> price;  // of the seeds
+    quantity<finance::euro> value;  // of the harvest at MSRP
+    quantity<one> cycles;           // harvests per 30 days
+
+    [[nodiscard]] auto margin() const -> quantity<finance::euro> { return value - price; }
+};
+
+[[nodiscard]] auto trayEconomics(Microgreen const& plant) -> TrayEconomics;
+
+// Seed prices in the file are in USD, they are converted at `eurPerUsd`
+[[nodiscard]] auto loadMicrogreens(std::filesystem::path const& path,
+                                   quantity<finance::euro / finance::us_dollar> eurPerUsd) -> std::vector<Microgreen>;
 
 struct GrowRack
 {
@@ -94,6 +109,9 @@ struct GrowContainer
     }
 };
 
+// Air conditioning needed to hold the temperature while the lights are on
+[[nodiscard]] auto coolingPower(GrowContainer const& gc) -> quantity<isq::power[si::watt]>;
+
 auto report(GrowContainer const& gc) -> void;
 auto report(GrowContainer const& gc, Microgreen const& plant) -> void;
 
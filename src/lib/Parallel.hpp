@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace tug
+{
+
+[[nodiscard]] inline auto hardwareThreads() noexcept -> std::size_t
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Calls func(i) for every i in [0, count). Indices are handed out in chunks of
+// `grain` from a shared counter, so uneven work per index still balances.
+template<typename Func>
+auto parallelFor(std::size_t count, Func const& func, std::size_t grain = 64) -> void
+{
+    auto const threads = std::min(hardwareThreads(), (count + grain - 1) / grain);
+    if (threads <= 1)
+    {
+        for (auto i = std::size_t{0}; i < count; ++i) { func(i); }
+        return;
+    }
+
+    auto next    = std::atomic<std::size_t>{0};
+    auto workers = std::vector<std::jthread>{};
+    workers.reserve(threads);
+    for (auto t = std::size_t{0}; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            for (auto first = next.fetch_add(grain); first < count; first = next.fetch_add(grain))
+            {
+                auto const last = std::min(first + grain, count);
+                for (auto i = first; i < last; ++i) { func(i); }
+            }
+        });
+    }
+}
+
+}  // namespace tug
@@ -11,13 +11,11 @@
 namespace tug
 {
 
-auto estimatePowerConsumption(QuadCopter const& copter, Flight const& flight) -> void
+auto estimateFlightPower(QuadCopter const& copter, Flight const& flight) -> FlightPower
 {
     using namespace mp_units::si::unit_symbols;
 
     QuantityOf<isq::altitude> auto altitude = flight.altitude;
-    QuantityOf<isq::length> auto distance   = flight.distance;
-    QuantityOf<isq::time> auto flightTime   = distance / flight.speed;
 
     QuantityOf<isq::mass> auto weight              = copter.weight;
     QuantityOf<isq::area> auto A_f                 = copter.frontalArea;
@@ -51,8 +49,38 @@ auto estimatePowerConsumption(QuadCopter const& copter, Flight const& flight) ->
     auto const vh3             = v_h * v_h * v_h;
     auto const powerHorizontal = 0.5 * C_D * A_f * rho * vh3;
 
+    return FlightPower{
+        .thrust     = thrust,
+        .climb      = v_v,
+        .vertical   = powerVertical,
+        .horizontal = powerHorizontal,
+    };
+}
+
+auto estimateFlightEnergy(QuadCopter const& copter, Flight const& flight) -> quantity<isq::energy[si::joule]>
+{
+    QuantityOf<isq::time> auto flightTime = flight.distance / flight.speed;
+    QuantityOf<isq::power> auto power     = estimateFlightPower(copter, flight).total();
+    return power * flightTime;
+}
+
+auto estimatePowerConsumption(QuadCopter const& copter, Flight const& flight) -> void
+{
+    using namespace mp_units::si::unit_symbols;
+
+    QuantityOf<isq::altitude> auto altitude = flight.altitude;
+    QuantityOf<isq::length> auto distance   = flight.distance;
+    QuantityOf<isq::time> auto flightTime   = distance / flight.speed;
+
+    QuantityOf<isq::mass> auto weight = copter.weight;
+    QuantityOf<isq::area> auto A_f    = copter.frontalArea;
+    QuantityOf<isq::speed> auto v_h   = flight.speed;
+    QuantityOf<isq::density> auto rho = densityAt(altitude);
+
+    auto const flightPower = estimateFlightPower(copter, flight);
+
     // Power-Total
-    QuantityOf<isq::power> auto power                  = powerHorizontal + powerVertical;
+    QuantityOf<isq::power> auto power                  = flightPower.total();
     QuantityOf<isq::power / isq::mass> auto powerRatio = power / weight;
     QuantityOf<isq::energy> auto energy                = power * flightTime;
 
@@ -60,17 +88,17 @@ auto estimatePowerConsumption(QuadCopter const& copter, Flight const& flight) ->
     fmt::println("------------------");
     fmt::println("Weight:      {::N[.3f]}", weight.in(g));
     fmt::println("Area_f:      {::N[.3f]}", A_f.in(m2));
-    fmt::println("Thrust:      {::N[.3f]}\n", thrust.in(N));
+    fmt::println("Thrust:      {::N[.3f]}\n", flightPower.thrust.in(N));
 
     fmt::println("Distance:    {::N[.3f]}", distance.in(km));
     fmt::println("Altitude:    {::N[.3f]}", altitude.in(m));
     fmt::println("Air-Density: {::N[.3f]}\n", rho.in(kg / m3));
 
-    fmt::println("Speed_v:     {::N[.3f]}", v_v.in(m / s));
+    fmt::println("Speed_v:     {::N[.3f]}", flightPower.climb.in(m / s));
     fmt::println("Speed_h:     {::N[.3f]}\n", v_h.in(km / h));
 
-    fmt::println("Power_v:     {::N[.3f]}", powerVertical.in(W));
-    fmt::println("Power_h:     {::N[.3f]}", powerHorizontal.in(W));
+    fmt::println("Power_v:     {::N[.3f]}", flightPower.vertical.in(W));
+    fmt::println("Power_h:     {::N[.3f]}", flightPower.horizontal.in(W));
     fmt::println("Power_t:     {::N[.3f]}", power.in(W));
     fmt::println("Power-Ratio: {::N[.3f]}\n", powerRatio.in(W / kg));
 
@@ -44,6 +44,20 @@ struct QuadCopter
     quantity<isq::maximum_efficiency[percent]> aerodynamicEfficiency;
 };
 
+struct FlightPower
+{
+    quantity<isq::force[si::newton]> thrust;
+    quantity<isq::speed[si::metre / si::second]> climb;  // vertical speed the vertical power is sized for
+    quantity<isq::power[si::watt]> vertical;
+    quantity<isq::power[si::watt]> horizontal;
+
+    [[nodiscard]] constexpr auto total() const noexcept -> QuantityOf<isq::power> auto { return vertical + horizontal; }
+};
+
+[[nodiscard]] auto estimateFlightPower(QuadCopter const& copter, Flight const& flight) -> FlightPower;
+[[nodiscard]] auto estimateFlightEnergy(QuadCopter const& copter, Flight const& flight)
+    -> quantity<isq::energy[si::joule]>;
+
 auto estimatePowerConsumption(QuadCopter const& copter, Flight const& flight) -> void;
 
 }  // namespace tug
@@ -0,0 +1,314 @@
+#include "RackLayout.hpp"
+
+#include "Parallel.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace tug
+{
+
+namespace
+{
+
+constexpr auto epsilon = 1e-9;
+
+struct Item
+{
+    std::size_t rack;
+    RackLayout::Side side;
+    double width;    // [m]
+    double area;     // [m2]
+    double cooling;  // [W]
+    double value;    // tray area minus weighted cooling [m2]
+};
+
+// One wall depth combination: every rack type that fits the depth of its wall,
+// sorted by value per metre of wall so the search finds good layouts early.
+struct Problem
+{
+    std::vector<Item> items;
+    std::vector<std::array<double, 2>> density;  // best value per metre on each wall from item k on
+    std::vector<double> ratio;                   // best value per watt from item k on
+};
+
+struct Solution
+{
+    double value{-1.0};
+    std::size_t problem{0};
+    std::vector<int> counts;
+};
+
+[[nodiscard]] auto sideIndex(RackLayout::Side side) noexcept -> std::size_t
+{
+    return side == RackLayout::Side::Left ? 0 : 1;
+}
+
+auto raise(std::atomic<double>& incumbent, double value) noexcept -> void
+{
+    auto current = incumbent.load();
+    while (value > current && !incumbent.compare_exchange_weak(current, value)) {}
+}
+
+[[nodiscard]] auto makeProblem(std::vector<Item> items) -> Problem
+{
+    std::ranges::stable_sort(items, std::ranges::greater{}, [](auto const& i) { return i.value / i.width; });
+
+    auto problem = Problem{.items = std::move(items), .density = {}, .ratio = {}};
+    auto const n = problem.items.size();
+    problem.density.assign(n + 1, {0.0, 0.0});
+    problem.ratio.assign(n + 1, 0.0);
+    for (auto k = n; k-- > 0;)
+    {
+        auto const& item = problem.items[k];
+        auto const side  = sideIndex(item.side);
+
+        problem.density[k]       = problem.density[k + 1];
+        problem.density[k][side] = std::max(problem.density[k][side], item.value / item.width);
+        problem.ratio[k]         = item.cooling > 0.0 ? std::max(problem.ratio[k + 1], item.value / item.cooling)
+                                                      : std::numeric_limits<double>::infinity();
+    }
+    return problem;
+}
+
+// Depth first over the count of each item, largest count first. A branch is
+// cut when neither the free wall length nor the free cooling capacity, filled
+// at the best remaining ratio, can reach the best layout found by any thread.
+// Only strictly worse branches are cut, so every layout that ties the optimum
+// is visited no matter how the threads are timed.
+class Search
+{
+public:
+    Search(Problem const& problem, std::atomic<double>& incumbent, double length, double cooling)
+        : _problem{problem}
+        , _incumbent{incumbent}
+        , _length{length}
+        , _cooling{cooling}
+        , _counts(problem.items.size(), 0)
+    {
+    }
+
+    [[nodiscard]] auto run(int first) -> std::pair<double, std::vector<int>>
+    {
+        auto const& item = _problem.items.front();
+        auto free        = std::array{_length, _length};
+        free[sideIndex(item.side)] -= first * item.width;
+
+        auto const cooling = _cooling - first * item.cooling;
+        if (free[sideIndex(item.side)] < -epsilon || cooling < -epsilon) { return {_best, _bestCounts}; }
+
+        _counts[0] = first;
+        visit(1, first * item.value, free, cooling);
+        return {_best, _bestCounts};
+    }
+
+private:
+    [[nodiscard]] auto bound(std::size_t k, double value, std::array<double, 2> free, double cooling) const -> double
+    {
+        auto const& density = _problem.density[k];
+        auto const byLength = value + free[0] * density[0] + free[1] * density[1];
+        auto const byPower  = value + cooling * _problem.ratio[k];
+        return std::min(byLength, byPower);
+    }
+
+    auto visit(std::size_t k, double value, std::array<double, 2> free, double cooling) -> void
+    {
+        if (value > _best)
+        {
+            _best       = value;
+            _bestCounts = _counts;
+            raise(_incumbent, value);
+        }
+
+        if (k == _problem.items.size()) { return; }
+        if (bound(k, value, free, cooling) < _incumbent.load() - epsilon) { return; }
+
+        auto const& item = _problem.items[k];
+        auto const side  = sideIndex(item.side);
+
+        auto most = static_cast<int>(std::floor((free[side] + epsilon) / item.width));
+        if (item.cooling > 0.0) { most = std::min(most, static_cast<int>(std::floor(cooling / item.cooling))); }
+
+        for (auto n = std::max(most, 0); n >= 0; --n)
+        {
+            auto next  = free;
+            next[side] = free[side] - n * item.width;
+
+            _counts[k] = n;
+            visit(k + 1, value + n * item.value, next, cooling - n * item.cooling);
+        }
+        _counts[k] = 0;
+    }
+
+    Problem const& _problem;
+    std::atomic<double>& _incumbent;
+    double _length;
+    double _cooling;
+
+    std::vector<int> _counts;
+    std::vector<int> _bestCounts;
+    double _best{-1.0};
+};
+
+[[nodiscard]] auto solve(std::vector<Problem> const& problems, double length, double cooling) -> Solution
+{
+    // Split every problem by the count of its first item, so even a single
+    // depth combination keeps all threads busy.
+    struct Task
+    {
+        std::size_t problem;
+        int first;
+    };
+
+    auto tasks = std::vector<Task>{};
+    for (auto p = std::size_t{0}; p < problems.size(); ++p)
+    {
+        auto const& item = problems[p].items.front();
+        auto most        = static_cast<int>(std::floor((length + epsilon) / item.width));
+        if (item.cooling > 0.0) { most = std::min(most, static_cast<int>(std::floor(cooling / item.cooling))); }
+        for (auto n = std::max(most, 0); n >= 0; --n) { tasks.push_back({p, n}); }
+    }
+
+    auto incumbent = std::atomic<double>{0.0};
+    auto results   = std::vector<Solution>(tasks.size());
+    parallelFor(
+        tasks.size(),
+        [&](std::size_t t) {
+            auto const& task = tasks[t];
+            auto search      = Search{problems[task.problem], incumbent, length, cooling};
+            auto [value, counts] = search.run(task.first);
+            results[t]           = Solution{.value = value, .problem = task.problem, .counts = std::move(counts)};
+        },
+        1);
+
+    // ties go to the first task, reruns print the same placements
+    auto const best = std::ranges::max(results, {}, &Solution::value).value;
+    auto const tie  = std::ranges::find_if(results, [&](auto const& r) { return r.value >= best - epsilon; });
+    return std::move(*tie);
+}
+
+}  // namespace
+
+auto optimizeRackLayout(IntermodalContainer const& container, std::span<GrowRack const> racks,
+                        RackClearance const& clearance, RackGoal const& goal) -> RackLayout
+{
+    auto const length  = (container.length - clearance.door).numerical_value_in(si::metre);
+    auto const width   = (container.width - clearance.aisle).numerical_value_in(si::metre);
+    auto const cooling = goal.maxCooling.numerical_value_in(si::watt);
+    auto const waste   = goal.light.waste().numerical_value_in(si::watt) * goal.lightsPerShelf.numerical_value_in(one);
+    auto const weight  = goal.coolingWeight.numerical_value_in(square(si::metre) / si::watt);
+
+    auto usable = std::vector<Item>{};
+    for (auto r = std::size_t{0}; r < racks.size(); ++r)
+    {
+        auto const& rack = racks[r];
+        if (rack.height + clearance.ceiling > container.height) { continue; }
+
+        auto const shelfs = rack.shelfs.numerical_value_in(one);
+        auto const trays  = std::floor((rack.width / rack.tray).numerical_value_in(one)) * shelfs;
+        auto const area   = trays * (rack.tray * rack.depth).numerical_value_in(square(si::metre));
+        auto const heat   = waste * shelfs;
+
+        auto const item = Item{
+            .rack    = r,
+            .side    = RackLayout::Side::Left,
+            .width   = rack.width.numerical_value_in(si::metre),
+            .area    = area,
+            .cooling = heat,
+            .value   = area - weight * heat,
+        };
+        if (item.value > epsilon && item.width > epsilon) { usable.push_back(item); }
+    }
+
+    // Wall depth is set by its deepest rack. For every depth of the left wall
+    // only the deepest right wall that still leaves the aisle free is worth
+    // searching, a shallower one allows a subset of the racks. Mirrored
+    // combinations are skipped.
+    auto depths = std::vector<double>{0.0};
+    for (auto const& item : usable) { depths.push_back(racks[item.rack].depth.numerical_value_in(si::metre)); }
+    std::ranges::sort(depths);
+    depths.erase(std::ranges::unique(depths).begin(), depths.end());
+
+    auto problems = std::vector<Problem>{};
+    for (auto left : depths)
+    {
+        auto right = -1.0;
+        for (auto d : depths)
+        {
+            if (d <= left && left + d <= width + epsilon) { right = d; }
+        }
+        if (right < 0.0) { continue; }
+
+        auto items = std::vector<Item>{};
+        for (auto const& item : usable)
+        {
+            auto const depth = racks[item.rack].depth.numerical_value_in(si::metre);
+            if (depth <= left + epsilon) { items.push_back(item); }
+            if (depth <= right + epsilon)
+            {
+                items.push_back(item);
+                items.back().side = RackLayout::Side::Right;
+            }
+        }
+        if (!items.empty()) { problems.push_back(makeProblem(std::move(items))); }
+    }
+
+    auto layout = RackLayout{.placements = {}, .trayArea = 0.0 * square(si::metre), .cooling = 0.0 * si::watt};
+    if (problems.empty()) { return layout; }
+
+    auto const best = solve(problems, length, cooling);
+    if (best.counts.empty()) { return layout; }
+
+    auto const& items = problems[best.problem].items;
+
+    auto offset = std::array{0.0, 0.0};
+    auto area   = 0.0;
+    auto heat   = 0.0;
+    for (auto k = std::size_t{0}; k < items.size(); ++k)
+    {
+        auto const& item = items[k];
+        for (auto n = 0; n < best.counts[k]; ++n)
+        {
+            auto& at = offset[sideIndex(item.side)];
+            layout.placements.push_back({.rack = item.rack, .side = item.side, .offset = at * si::metre});
+            at += item.width;
+            area += item.area;
+            heat += item.cooling;
+        }
+    }
+
+    layout.trayArea = area * square(si::metre);
+    layout.cooling  = heat * si::watt;
+    return layout;
+}
+
+auto report(RackLayout const& layout, std::span<GrowRack const> racks) -> void
+{
+    using namespace mp_units::si::unit_symbols;
+
+    auto counts = std::vector<std::array<int, 2>>(racks.size(), {0, 0});
+    for (auto const& placement : layout.placements) { ++counts[placement.rack][sideIndex(placement.side)]; }
+
+    fmt::println("Rack-Layout:");
+    fmt::println("-----------");
+    fmt::println("Racks:      {}", layout.placements.size());
+    for (auto r = std::size_t{0}; r < racks.size(); ++r)
+    {
+        auto const& rack = racks[r];
+        fmt::println("Rack-{}:     {} left, {} right ({} x {} x {}, {} shelfs)", r, counts[r][0], counts[r][1],
+                     rack.width.in(cm), rack.depth.in(cm), rack.height.in(cm), rack.shelfs);
+    }
+    fmt::println("Tray-Area:  {::N[.2f]}", layout.trayArea.in(m2));
+    fmt::println("Cooling:    {::N[.2f]}", layout.cooling.in(W));
+    fmt::println("");
+}
+
+}  // namespace tug
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "IntermodalContainer.hpp"
+#include "Light.hpp"
+#include "Microgreens.hpp"
+
+#include <mp-units/systems/isq.h>
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+struct RackClearance
+{
+    quantity<isq::width[si::metre]> aisle;     // walkway between the two wall rows
+    quantity<isq::length[si::metre]> door;     // kept free in front of the doors
+    quantity<isq::height[si::metre]> ceiling;  // above the racks for air flow
+};
+
+struct RackGoal
+{
+    GrowLight light;
+    quantity<one, int> lightsPerShelf;
+    quantity<isq::power[si::watt]> maxCooling;  // capacity of the air conditioning
+
+    // tray area one watt of cooling load is worth, zero maximizes tray area only
+    quantity<isq::area[square(si::metre)] / isq::power[si::watt]> coolingWeight;
+};
+
+struct RackLayout
+{
+    enum class Side
+    {
+        Left,
+        Right,
+    };
+
+    struct Placement
+    {
+        std::size_t rack;  // index into the rack types
+        Side side;
+        quantity<isq::length[si::metre]> offset;  // from the back wall
+    };
+
+    std::vector<Placement> placements;
+    quantity<isq::area[square(si::metre)]> trayArea;
+    quantity<isq::power[si::watt]> cooling;
+};
+
+// Places racks of mixed types along both side walls of the container, racks
+// face the aisle in the middle, the door end stays clear. Solved exactly with
+// a parallel branch-and-bound over rack counts per wall.
+[[nodiscard]] auto optimizeRackLayout(IntermodalContainer const& container, std::span<GrowRack const> racks,
+                                      RackClearance const& clearance, RackGoal const& goal) -> RackLayout;
+
+auto report(RackLayout const& layout, std::span<GrowRack const> racks) -> void;
+
+}  // namespace tug
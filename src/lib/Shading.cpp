@@ -0,0 +1,333 @@
+#include "Shading.hpp"
+
+#include "Parallel.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <numbers>
+#include <stdexcept>
+
+namespace tug
+{
+
+namespace
+{
+
+using Vec3 = std::array<double, 3>;
+
+constexpr auto infinity      = std::numeric_limits<double>::infinity();
+constexpr auto epsilon       = 1e-6;  // [m]
+constexpr auto azimuthBins   = std::size_t{180};
+constexpr auto elevationBins = std::size_t{90};
+constexpr auto samplesX      = std::size_t{4};
+constexpr auto samplesY      = std::size_t{4};
+constexpr auto clearSky      = 1'000.0;  // [W/m2] at the zenith
+constexpr auto leafSize      = std::uint32_t{4};
+
+struct Aabb
+{
+    Vec3 min{infinity, infinity, infinity};
+    Vec3 max{-infinity, -infinity, -infinity};
+
+    auto grow(Aabb const& other) noexcept -> void
+    {
+        for (auto a = std::size_t{0}; a < 3; ++a)
+        {
+            min[a] = std::min(min[a], other.min[a]);
+            max[a] = std::max(max[a], other.max[a]);
+        }
+    }
+
+    [[nodiscard]] auto center(std::size_t axis) const noexcept -> double { return 0.5 * (min[axis] + max[axis]); }
+};
+
+struct Ray
+{
+    Vec3 origin;
+    Vec3 inverse;  // 1 / direction per axis
+};
+
+// Slab test, only hits in front of the origin count
+[[nodiscard]] auto hits(Aabb const& box, Ray const& ray) noexcept -> bool
+{
+    auto near = epsilon;
+    auto far  = infinity;
+    for (auto a = std::size_t{0}; a < 3; ++a)
+    {
+        auto t0 = (box.min[a] - ray.origin[a]) * ray.inverse[a];
+        auto t1 = (box.max[a] - ray.origin[a]) * ray.inverse[a];
+        if (t0 > t1) { std::swap(t0, t1); }
+        near = std::max(near, t0);
+        far  = std::min(far, t1);
+    }
+    return near <= far;
+}
+
+// Bounding volume hierarchy over axis aligned boxes, split at the median
+// centroid of the longest axis. Only answers "is anything in the way".
+class Bvh
+{
+public:
+    explicit Bvh(std::vector<Aabb> boxes) : _boxes{std::move(boxes)}
+    {
+        if (_boxes.empty()) { return; }
+        _nodes.push_back({});
+        build(0, 0, _boxes.size());
+    }
+
+    [[nodiscard]] auto occluded(Ray const& ray) const noexcept -> bool
+    {
+        if (_nodes.empty()) { return false; }
+
+        auto stack = std::array<std::uint32_t, 64>{};
+        auto top   = std::size_t{0};
+        stack[top++] = 0;
+
+        while (top > 0)
+        {
+            auto const& node = _nodes[stack[--top]];
+            if (!hits(node.bounds, ray)) { continue; }
+
+            if (node.count > 0)
+            {
+                auto const boxes = std::span{_boxes}.subspan(node.first, node.count);
+                if (std::ranges::any_of(boxes, [&](auto const& box) { return hits(box, ray); })) { return true; }
+                continue;
+            }
+
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+        return false;
+    }
+
+private:
+    struct Node
+    {
+        Aabb bounds;
+        std::uint32_t first{0};  // first box of a leaf, left child otherwise
+        std::uint32_t count{0};  // zero for inner nodes
+    };
+
+    auto build(std::size_t node, std::size_t first, std::size_t last) -> void
+    {
+        auto bounds    = Aabb{};
+        auto centroids = Aabb{};
+        for (auto i = first; i < last; ++i)
+        {
+            bounds.grow(_boxes[i]);
+            auto const c = Vec3{_boxes[i].center(0), _boxes[i].center(1), _boxes[i].center(2)};
+            centroids.grow(Aabb{.min = c, .max = c});
+        }
+        _nodes[node].bounds = bounds;
+
+        if (last - first <= leafSize)
+        {
+            _nodes[node].first = static_cast<std::uint32_t>(first);
+            _nodes[node].count = static_cast<std::uint32_t>(last - first);
+            return;
+        }
+
+        auto axis = std::size_t{0};
+        for (auto a = std::size_t{1}; a < 3; ++a)
+        {
+            if (centroids.max[a] - centroids.min[a] > centroids.max[axis] - centroids.min[axis]) { axis = a; }
+        }
+
+        auto const mid = first + (last - first) / 2;
+        std::nth_element(_boxes.begin() + static_cast<std::ptrdiff_t>(first),
+                         _boxes.begin() + static_cast<std::ptrdiff_t>(mid),
+                         _boxes.begin() + static_cast<std::ptrdiff_t>(last),
+                         [axis](auto const& l, auto const& r) { return l.center(axis) < r.center(axis); });
+
+        auto const left    = _nodes.size();
+        _nodes[node].first = static_cast<std::uint32_t>(left);
+        _nodes.resize(left + 2);
+        build(left, first, mid);
+        build(left + 1, mid, last);
+    }
+
+    std::vector<Aabb> _boxes;
+    std::vector<Node> _nodes;
+};
+
+struct SunBin
+{
+    Vec3 direction;
+    double weight;  // clear-sky irradiation on a horizontal surface [J/m2]
+};
+
+// Sun position from declination and hour angle in local solar time. Every
+// step is added to the bin of its direction, weighted with the horizontal
+// clear-sky irradiance, so each bin needs to be ray-cast only once.
+[[nodiscard]] auto sunBins(double latitude, double step) -> std::vector<SunBin>
+{
+    using std::numbers::pi;
+
+    auto weights = std::vector<double>(azimuthBins * elevationBins, 0.0);
+
+    auto const sinLat = std::sin(latitude);
+    auto const cosLat = std::max(std::cos(latitude), 1e-9);
+    for (auto day = 1; day <= 365; ++day)
+    {
+        auto const declination = 23.45 * pi / 180.0 * std::sin(2.0 * pi * (284.0 + day) / 365.0);
+        for (auto t = 0.5 * step; t < 86'400.0; t += step)
+        {
+            auto const hourAngle = (t / 3'600.0 - 12.0) * 15.0 * pi / 180.0;
+            auto const sinAlt    = sinLat * std::sin(declination)
+                              + cosLat * std::cos(declination) * std::cos(hourAngle);
+            if (sinAlt <= 0.0) { continue; }
+
+            auto const altitude = std::asin(sinAlt);
+            auto const cosAz    = (std::sin(declination) - sinAlt * sinLat) / (std::cos(altitude) * cosLat);
+            auto azimuth        = std::acos(std::clamp(cosAz, -1.0, 1.0));
+            if (hourAngle > 0.0) { azimuth = 2.0 * pi - azimuth; }
+
+            auto const a = std::min(static_cast<std::size_t>(azimuth / (2.0 * pi) * azimuthBins), azimuthBins - 1);
+            auto const e = std::min(static_cast<std::size_t>(altitude / (0.5 * pi) * elevationBins), elevationBins - 1);
+            weights[a * elevationBins + e] += clearSky * sinAlt * step;
+        }
+    }
+
+    auto bins = std::vector<SunBin>{};
+    for (auto a = std::size_t{0}; a < azimuthBins; ++a)
+    {
+        for (auto e = std::size_t{0}; e < elevationBins; ++e)
+        {
+            auto const weight = weights[a * elevationBins + e];
+            if (weight <= 0.0) { continue; }
+
+            auto const azimuth   = (static_cast<double>(a) + 0.5) / azimuthBins * 2.0 * pi;
+            auto const elevation = (static_cast<double>(e) + 0.5) / elevationBins * 0.5 * pi;
+            auto const direction = Vec3{
+                std::sin(azimuth) * std::cos(elevation),
+                std::cos(azimuth) * std::cos(elevation),
+                std::sin(elevation),
+            };
+            bins.push_back({.direction = direction, .weight = weight});
+        }
+    }
+    return bins;
+}
+
+}  // namespace
+
+auto computeShading(Site const& site) -> std::vector<PanelShading>
+{
+    if (!(site.step > 0.0 * si::minute)) { throw std::invalid_argument{"shading needs a positive time step"}; }
+    for (auto const& mounted : site.panels)
+    {
+        if (mounted.container >= site.containers.size())
+        {
+            throw std::invalid_argument{"roof panel refers to a container that is not on the site"};
+        }
+    }
+
+    auto const metres = [](auto q) { return q.numerical_value_in(si::metre); };
+
+    auto boxes = std::vector<Aabb>{};
+    for (auto const& placed : site.containers)
+    {
+        auto const outside = placed.container.outside();
+        auto const length  = metres(outside.length);
+        auto const width   = metres(outside.width);
+        auto const height  = metres(outside.height);
+        auto const min     = Vec3{metres(placed.x), metres(placed.y), metres(placed.z)};
+        auto const size    = placed.rotated ? Vec3{width, length, height} : Vec3{length, width, height};
+        boxes.push_back({.min = min, .max = {min[0] + size[0], min[1] + size[1], min[2] + size[2]}});
+    }
+    for (auto const& obstacle : site.obstacles)
+    {
+        auto const min = Vec3{metres(obstacle.x), metres(obstacle.y), metres(obstacle.z)};
+        boxes.push_back({
+            .min = min,
+            .max = {min[0] + metres(obstacle.sizeX), min[1] + metres(obstacle.sizeY), min[2] + metres(obstacle.height)},
+        });
+    }
+
+    auto const bvh   = Bvh{std::move(boxes)};
+    auto const bins  = sunBins(site.latitude.numerical_value_in(si::radian), site.step.numerical_value_in(si::second));
+    auto const total = std::accumulate(bins.begin(), bins.end(), 0.0,
+                                       [](auto sum, auto const& bin) { return sum + bin.weight; });
+
+    auto result = std::vector<PanelShading>(site.panels.size());
+    parallelFor(
+        site.panels.size(),
+        [&](std::size_t p) {
+            auto const& mounted = site.panels[p];
+            auto const& placed  = site.containers[mounted.container];
+
+            auto const x0    = metres(placed.x) + metres(mounted.x);
+            auto const y0    = metres(placed.y) + metres(mounted.y);
+            auto const roof  = metres(placed.z) + metres(placed.container.outside().height);
+            auto const z0    = roof + metres(mounted.rack) + epsilon;
+            auto const sizeX = metres(mounted.panel.width);
+            auto const sizeY = metres(mounted.panel.height);
+
+            auto points = std::vector<Vec3>{};
+            for (auto i = std::size_t{0}; i < samplesX; ++i)
+            {
+                for (auto j = std::size_t{0}; j < samplesY; ++j)
+                {
+                    points.push_back({
+                        x0 + (static_cast<double>(i) + 0.5) / samplesX * sizeX,
+                        y0 + (static_cast<double>(j) + 0.5) / samplesY * sizeY,
+                        z0,
+                    });
+                }
+            }
+
+            auto received = 0.0;
+            for (auto const& bin : bins)
+            {
+                auto const& d  = bin.direction;
+                auto const inv = Vec3{1.0 / d[0], 1.0 / d[1], 1.0 / d[2]};
+                auto const lit = std::ranges::count_if(points, [&](auto const& point) {
+                    return !bvh.occluded(Ray{.origin = point, .inverse = inv});
+                });
+                received += bin.weight * static_cast<double>(lit) / static_cast<double>(points.size());
+            }
+
+            auto const area       = mounted.panel.area().numerical_value_in(square(si::metre));
+            auto const efficiency = mounted.panel.efficiency.numerical_value_in(one);
+            auto const sunlit     = total > 0.0 ? received / total : 0.0;
+
+            result[p].sunlit = 100.0 * sunlit * percent;
+            result[p].energy = received * area * efficiency * si::joule;
+        },
+        1);
+
+    return result;
+}
+
+auto report(Site const& site, std::span<PanelShading const> shading) -> void
+{
+    using namespace mp_units::si::unit_symbols;
+
+    fmt::println("Site-Shading:");
+    fmt::println("------------");
+    fmt::println("Latitude:   {}", site.latitude);
+    fmt::println("Containers: {}", site.containers.size());
+    fmt::println("Obstacles:  {}", site.obstacles.size());
+    fmt::println("Panels:     {}\n", site.panels.size());
+
+    quantity<isq::energy[si::kilo<si::watt> * si::hour]> total = 0.0 * kW * h;
+    for (auto p = std::size_t{0}; p < shading.size(); ++p)
+    {
+        fmt::println("Panel-{}:    {::N[.1f]} sunlit, {::N[.1f]}", p, shading[p].sunlit, shading[p].energy.in(kW * h));
+        total += shading[p].energy;
+    }
+    fmt::println("Energy:     {::N[.1f]}", total.in(kW * h));
+    fmt::println("");
+}
+
+}  // namespace tug
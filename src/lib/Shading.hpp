@@ -0,0 +1,74 @@
+#pragma once
+
+#include "IntermodalContainer.hpp"
+#include "SolarPanel.hpp"
+
+#include <mp-units/systems/isq.h>
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+// Site coordinates: x points east, y north, z up, all from a common origin.
+
+struct ContainerPlacement
+{
+    IntermodalContainer container;  // inner dimensions, shadows and roofs use container.outside()
+    quantity<isq::length[si::metre]> x;
+    quantity<isq::length[si::metre]> y;
+    quantity<isq::height[si::metre]> z;  // base, non-zero for stacked containers
+    bool rotated;                        // length runs north-south instead of east-west
+};
+
+// HVAC units, parapets, anything else that casts a shadow
+struct Obstacle
+{
+    quantity<isq::length[si::metre]> x;
+    quantity<isq::length[si::metre]> y;
+    quantity<isq::height[si::metre]> z;
+    quantity<isq::length[si::metre]> sizeX;
+    quantity<isq::length[si::metre]> sizeY;
+    quantity<isq::height[si::metre]> height;
+};
+
+// Flat panel on a container roof, width runs east, height north
+struct RoofPanel
+{
+    SolarPanel panel;
+    std::size_t container;                  // index into Site::containers
+    quantity<isq::length[si::metre]> x;     // offset from the roof corner
+    quantity<isq::length[si::metre]> y;     // offset from the roof corner
+    quantity<isq::height[si::metre]> rack;  // mounting height above the roof
+};
+
+struct Site
+{
+    quantity<si::degree> latitude;
+    quantity<isq::time[si::minute]> step;
+    std::vector<ContainerPlacement> containers;
+    std::vector<Obstacle> obstacles;
+    std::vector<RoofPanel> panels;
+};
+
+struct PanelShading
+{
+    quantity<percent> sunlit;                                     // share of the clear-sky irradiation
+    quantity<isq::energy[si::kilo<si::watt> * si::hour]> energy;  // clear-sky yield over a year
+};
+
+// Walks the sun over every time step of the year, bins the sun vectors by
+// direction and ray-casts each bin once per panel sample point against a BVH
+// of all boxes on the site. Panels are evaluated in parallel.
+// Throws std::invalid_argument if the step is not positive or a panel's
+// container index is out of range.
+[[nodiscard]] auto computeShading(Site const& site) -> std::vector<PanelShading>;
+
+auto report(Site const& site, std::span<PanelShading const> shading) -> void;
+
+}  // namespace tug
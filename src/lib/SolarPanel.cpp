@@ -12,10 +12,10 @@ auto report(SolarPanel const& panel, SolarPanel::Location const& location) -> vo
 {
     using namespace mp_units::si::unit_symbols;
 
-    QuantityOf<isq::area> auto area     = panel.width * panel.height;
-    QuantityOf<isq::power> auto kWp     = area * (1.0 * kW / m2) * panel.efficiency;
-    QuantityOf<isq::power> auto output  = area * location.irradiance * panel.efficiency;
-    QuantityOf<isq::energy> auto energy = output * location.daylight;
+    QuantityOf<isq::area> auto area     = panel.area();
+    QuantityOf<isq::power> auto kWp     = panel.peakPower();
+    QuantityOf<isq::power> auto output  = panel.output(location);
+    QuantityOf<isq::energy> auto energy = panel.energy(location);
 
     fmt::println("Solar panel:");
     fmt::println("-----------");
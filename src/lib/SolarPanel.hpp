@@ -19,6 +19,23 @@ struct SolarPanel
     quantity<isq::width[si::metre]> width;
     quantity<isq::height[si::metre]> height;
     quantity<isq::maximum_efficiency[percent]> efficiency;
+
+    [[nodiscard]] constexpr auto area() const noexcept -> QuantityOf<isq::area> auto { return width * height; }
+
+    [[nodiscard]] constexpr auto peakPower() const noexcept -> QuantityOf<isq::power> auto
+    {
+        return area() * (1.0 * si::kilo<si::watt> / square(si::metre)) * efficiency;
+    }
+
+    [[nodiscard]] constexpr auto output(Location const& location) const noexcept -> QuantityOf<isq::power> auto
+    {
+        return area() * location.irradiance * efficiency;
+    }
+
+    [[nodiscard]] constexpr auto energy(Location const& location) const noexcept -> QuantityOf<isq::energy> auto
+    {
+        return output(location) * location.daylight;
+    }
 };
 
 auto report(SolarPanel const& panel, SolarPanel::Location const& location) -> void;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace tug
+{
+
+// Bounded single-producer single-consumer ring buffer. Head and tail are plain
+// atomics, a full queue blocks the producer and an empty one the consumer via
+// std::atomic::wait, which gives pipelines backpressure without locks or spinning.
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity) : _slots(std::bit_ceil(std::max<std::size_t>(capacity, 1))) {}
+
+    auto push(T value) -> void
+    {
+        auto const tail = _tail.load(std::memory_order_relaxed);
+        auto head       = _head.load(std::memory_order_acquire);
+        while (tail - head == _slots.size())
+        {
+            _head.wait(head, std::memory_order_acquire);
+            head = _head.load(std::memory_order_acquire);
+        }
+
+        _slots[tail & (_slots.size() - 1)] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        _tail.notify_one();
+    }
+
+    // Called by the producer after its last push
+    auto close() -> void
+    {
+        _tail.fetch_or(closed, std::memory_order_release);
+        _tail.notify_one();
+    }
+
+    // Returns std::nullopt once the queue is closed and drained
+    [[nodiscard]] auto pop() -> std::optional<T>
+    {
+        auto const head = _head.load(std::memory_order_relaxed);
+        auto tail       = _tail.load(std::memory_order_acquire);
+        while ((tail & ~closed) == head)
+        {
+            if ((tail & closed) != 0) { return std::nullopt; }
+            _tail.wait(tail, std::memory_order_acquire);
+            tail = _tail.load(std::memory_order_acquire);
+        }
+
+        auto value = std::move(_slots[head & (_slots.size() - 1)]);
+        _head.store(head + 1, std::memory_order_release);
+        _head.notify_one();
+        return value;
+    }
+
+private:
+    static constexpr auto closed = std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1);
+
+    std::vector<T> _slots;
+    alignas(64) std::atomic<std::size_t> _head{0};
+    alignas(64) std::atomic<std::size_t> _tail{0};
+};
+
+}  // namespace tug
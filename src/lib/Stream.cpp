@@ -0,0 +1,507 @@
+#include "Stream.hpp"
+
+#include "File.hpp"
+#include "Microgreens.hpp"
+#include "Parallel.hpp"
+#include "QuadCopter.hpp"
+#include "SolarPanel.hpp"
+#include "SpscQueue.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tug
+{
+
+namespace
+{
+
+constexpr auto queueDepth = std::size_t{4};  // blocks in flight per worker
+constexpr auto readChunk  = std::size_t{1} << 20;
+
+struct FlightScenario
+{
+    using Record = std::array<double, 7>;
+    using Result = std::array<double, 3>;
+
+    static constexpr auto fields = std::array<std::string_view, 7>{
+        "distance_km", "altitude_m", "speed_kmh", "weight_kg", "frontal_area_m2", "thrust_efficiency_pct",
+        "aerodynamic_efficiency_pct",
+    };
+    static constexpr auto results = std::array<std::string_view, 3>{"power_w", "time_h", "energy_kwh"};
+
+    [[nodiscard]] static auto compute(Record const& in) -> Result
+    {
+        using namespace mp_units::si::unit_symbols;
+
+        auto const copter = QuadCopter{
+            .weight                = in[3] * kg,
+            .frontalArea           = in[4] * m2,
+            .thrustEfficiency      = in[5] * percent,
+            .aerodynamicEfficiency = in[6] * percent,
+        };
+        auto const flight = Flight{
+            .distance = in[0] * km,
+            .altitude = in[1] * m,
+            .speed    = in[2] * km / h,
+        };
+
+        return {
+            estimateFlightPower(copter, flight).total().numerical_value_in(W),
+            (flight.distance / flight.speed).numerical_value_in(h),
+            estimateFlightEnergy(copter, flight).numerical_value_in(kW * h),
+        };
+    }
+};
+
+struct ContainerScenario
+{
+    using Record = std::array<double, 12>;
+    using Result = std::array<double, 5>;
+
+    static constexpr auto fields = std::array<std::string_view, 12>{
+        "length_m",    "width_m", "height_m", "rack_depth_m",  "rack_width_m",         "rack_height_m",
+        "rack_shelfs", "tray_m",  "rows",     "light_power_w", "light_efficiency_pct", "lights_per_shelf",
+    };
+    static constexpr auto results = std::array<std::string_view, 5>{
+        "racks", "trays", "tray_area_m2", "power_w", "energy_kwh_per_day",
+    };
+
+    // the counts are converted to int
+    [[nodiscard]] static auto valid(Record const& in) -> bool
+    {
+        auto const count = [](double value) {
+            return value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+        };
+        return count(in[6]) && count(in[8]) && count(in[11]);
+    }
+
+    [[nodiscard]] static auto compute(Record const& in) -> Result
+    {
+        using namespace mp_units::si::unit_symbols;
+
+        auto const gc = GrowContainer{
+            .container = {.length = in[0] * m, .width = in[1] * m, .height = in[2] * m},
+            .rack =
+                {
+                    .depth  = in[3] * m,
+                    .width  = in[4] * m,
+                    .height = in[5] * m,
+                    .shelfs = static_cast<int>(in[6]) * one,
+                    .tray   = in[7] * m,
+                },
+            .light          = {.power = in[9] * W, .efficiency = in[10] * percent},
+            .rows           = static_cast<int>(in[8]) * one,
+            .lightsPerShelf = static_cast<int>(in[11]) * one,
+        };
+
+        // same 8 light-hours per day as report(GrowContainer)
+        QuantityOf<isq::power> auto power = gc.powerLights() + coolingPower(gc);
+
+        return {
+            gc.racks().numerical_value_in(one),
+            gc.trays().numerical_value_in(one),
+            gc.trayArea().numerical_value_in(m2),
+            power.numerical_value_in(W),
+            (power * (8.0 * h)).numerical_value_in(kW * h),
+        };
+    }
+};
+
+struct PanelScenario
+{
+    using Record = std::array<double, 5>;
+    using Result = std::array<double, 3>;
+
+    static constexpr auto fields = std::array<std::string_view, 5>{
+        "width_m", "height_m", "efficiency_pct", "irradiance_w_m2", "daylight_h",
+    };
+    static constexpr auto results = std::array<std::string_view, 3>{"peak_kw", "output_kw", "energy_kwh"};
+
+    [[nodiscard]] static auto compute(Record const& in) -> Result
+    {
+        using namespace mp_units::si::unit_symbols;
+
+        auto const panel    = SolarPanel{.width = in[0] * m, .height = in[1] * m, .efficiency = in[2] * percent};
+        auto const location = SolarPanel::Location{.irradiance = in[3] * W / m2, .daylight = in[4] * h};
+
+        return {
+            panel.peakPower().numerical_value_in(kW),
+            panel.output(location).numerical_value_in(kW),
+            panel.energy(location).numerical_value_in(kW * h),
+        };
+    }
+};
+
+[[nodiscard]] auto trim(std::string_view str) -> std::string_view
+{
+    auto const first = str.find_first_not_of(" \t\"");
+    if (first == std::string_view::npos) { return {}; }
+    auto const last = str.find_last_not_of(" \t\"");
+    return str.substr(first, last - first + 1);
+}
+
+// Parses a number at the front of `str`, trailing characters are left alone
+[[nodiscard]] auto parseNumber(std::string_view str, double& value) -> char const*
+{
+    auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc{} ? end : nullptr;
+}
+
+template<typename Scenario>
+class Parser
+{
+public:
+    using Record = typename Scenario::Record;
+
+    explicit Parser(bool ndjson) : _ndjson{ndjson}
+    {
+        for (auto f = std::size_t{0}; f < Scenario::fields.size(); ++f)
+        {
+            _keys[f] = fmt::format("\"{}\"", Scenario::fields[f]);
+        }
+    }
+
+    [[nodiscard]] auto expectsHeader() const noexcept -> bool { return !_ndjson && _columns.empty(); }
+
+    // Maps CSV columns to fields by name, extra columns are ignored
+    auto header(std::string_view line) -> void
+    {
+        auto found = std::array<bool, Scenario::fields.size()>{};
+        for (auto column = std::size_t{0}; !line.empty(); ++column)
+        {
+            auto const comma = line.find(',');
+            auto const name  = trim(line.substr(0, comma));
+            line             = comma == std::string_view::npos ? std::string_view{} : line.substr(comma + 1);
+
+            _columns.push_back(-1);
+            for (auto f = std::size_t{0}; f < Scenario::fields.size(); ++f)
+            {
+                if (name == Scenario::fields[f])
+                {
+                    _columns.back() = static_cast<int>(f);
+                    found[f]        = true;
+                }
+            }
+        }
+
+        for (auto f = std::size_t{0}; f < Scenario::fields.size(); ++f)
+        {
+            if (!found[f]) { throw std::runtime_error{fmt::format("missing column '{}'", Scenario::fields[f])}; }
+        }
+    }
+
+    // from_chars accepts "nan", "inf" and "1e300", such lines count as skipped
+    [[nodiscard]] auto parse(std::string_view line, Record& record) const -> bool
+    {
+        if (!(_ndjson ? parseObject(line, record) : parseRow(line, record))) { return false; }
+        if (!std::ranges::all_of(record, [](double value) { return std::isfinite(value); })) { return false; }
+        if constexpr (requires { Scenario::valid(record); }) { return Scenario::valid(record); }
+        return true;
+    }
+
+private:
+    [[nodiscard]] auto parseRow(std::string_view line, Record& record) const -> bool
+    {
+        auto parsed = std::size_t{0};
+        for (auto column = std::size_t{0}; column < _columns.size(); ++column)
+        {
+            auto const comma = line.find(',');
+            auto const token = trim(line.substr(0, comma));
+            line             = comma == std::string_view::npos ? std::string_view{} : line.substr(comma + 1);
+
+            auto const field = _columns[column];
+            if (field < 0) { continue; }
+
+            auto& value = record[static_cast<std::size_t>(field)];
+            if (parseNumber(token, value) != token.data() + token.size() || token.empty()) { return false; }
+            ++parsed;
+        }
+        return parsed == Scenario::fields.size();
+    }
+
+    // Flat objects only: looks up every key and reads the number after its colon
+    [[nodiscard]] auto parseObject(std::string_view line, Record& record) const -> bool
+    {
+        for (auto f = std::size_t{0}; f < Scenario::fields.size(); ++f)
+        {
+            auto const pos = line.find(_keys[f]);
+            if (pos == std::string_view::npos) { return false; }
+
+            auto rest        = line.substr(pos + _keys[f].size());
+            auto const colon = rest.find_first_not_of(" \t");
+            if (colon == std::string_view::npos || rest[colon] != ':') { return false; }
+            rest = trim(rest.substr(colon + 1));
+
+            if (parseNumber(rest, record[f]) == nullptr) { return false; }
+        }
+        return true;
+    }
+
+    bool _ndjson;
+    std::array<std::string, Scenario::fields.size()> _keys;
+    std::vector<int> _columns;  // field index per CSV column, -1 if unused
+};
+
+// A line-aligned slice of the input and the CSV text the worker made of it.
+// The sequence number restores the input order on the way out.
+struct Block
+{
+    std::size_t sequence;
+    std::string text;
+};
+
+struct Output
+{
+    std::size_t sequence;
+    std::string text;
+    std::size_t records;
+    std::size_t skipped;
+};
+
+template<typename Func>
+auto forEachLine(std::string_view text, Func const& func) -> void
+{
+    while (!text.empty())
+    {
+        auto const nl = text.find('\n');
+        auto line     = text.substr(0, nl);
+        text          = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+
+        if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+        if (!trim(line).empty()) { func(line); }
+    }
+}
+
+// Cuts the input into line-aligned blocks of about readChunk bytes and deals
+// them round robin, block i to worker i % workers. The CSV header is consumed
+// here before the first block goes out, the workers share the finished parser.
+template<typename Scenario>
+auto readStage(std::FILE* file, Parser<Scenario>& parser, std::deque<SpscQueue<Block>>& queues) -> void
+{
+    auto sequence = std::size_t{0};
+    auto const deal = [&](std::string text) {
+        while (parser.expectsHeader() && !text.empty())
+        {
+            auto const nl = text.find('\n');
+            auto line     = std::string_view{text}.substr(0, nl);
+            if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+            if (!trim(line).empty()) { parser.header(line); }
+            text.erase(0, nl == std::string::npos ? text.size() : nl + 1);
+        }
+        if (text.empty()) { return; }
+
+        queues[sequence % queues.size()].push(Block{.sequence = sequence, .text = std::move(text)});
+        ++sequence;
+    };
+
+    // Only the partial line at the end of a chunk is copied into the next one
+    auto carry = std::string{};
+    while (true)
+    {
+        auto text       = std::move(carry);
+        auto const kept = text.size();
+        text.resize(kept + readChunk);
+        auto const size = std::fread(text.data() + kept, 1, readChunk, file);
+        text.resize(kept + size);
+        if (size == 0)
+        {
+            carry = std::move(text);
+            break;
+        }
+
+        auto const nl = text.rfind('\n');
+        if (nl == std::string::npos)
+        {
+            carry = std::move(text);
+            continue;
+        }
+        carry.assign(text, nl + 1);
+        text.resize(nl + 1);
+        deal(std::move(text));
+    }
+    if (!carry.empty()) { deal(std::move(carry)); }
+
+    if (std::ferror(file) != 0) { throw std::runtime_error{"read error"}; }
+}
+
+// Parses, computes and formats whole blocks, the writer only copies bytes
+template<typename Scenario>
+auto computeStage(Parser<Scenario> const& parser, SpscQueue<Block>& in, SpscQueue<Output>& out) -> void
+{
+    while (auto block = in.pop())
+    {
+        auto output = Output{.sequence = block->sequence, .text = {}, .records = 0, .skipped = 0};
+        output.text.reserve(2 * block->text.size());
+        auto it = std::back_inserter(output.text);
+
+        forEachLine(block->text, [&](std::string_view line) {
+            auto record = typename Scenario::Record{};
+            if (!parser.parse(line, record))
+            {
+                ++output.skipped;
+                return;
+            }
+
+            auto const result = Scenario::compute(record);
+            fmt::format_to(it, "{}", record.front());
+            for (auto const value : std::span{record}.subspan(1)) { fmt::format_to(it, ",{}", value); }
+            for (auto const value : result) { fmt::format_to(it, ",{}", value); }
+            output.text.push_back('\n');
+            ++output.records;
+        });
+
+        out.push(std::move(output));
+    }
+}
+
+template<typename Scenario>
+auto writeStage(std::FILE* file, std::deque<SpscQueue<Output>>& queues) -> StreamStats
+{
+    auto const write = [&](std::string_view text) {
+        if (std::fwrite(text.data(), 1, text.size(), file) != text.size()) { throw std::runtime_error{"write error"}; }
+    };
+
+    auto header = std::string{Scenario::fields.front()};
+    auto it     = std::back_inserter(header);
+    for (auto const field : std::span{Scenario::fields}.subspan(1)) { fmt::format_to(it, ",{}", field); }
+    for (auto const field : Scenario::results) { fmt::format_to(it, ",{}", field); }
+    header.push_back('\n');
+    write(header);
+
+    // block i comes from worker i % workers, popping in that order restores the input order
+    auto stats = StreamStats{.records = 0, .skipped = 0};
+    for (auto sequence = std::size_t{0};; ++sequence)
+    {
+        auto output = queues[sequence % queues.size()].pop();
+        if (!output) { break; }
+        if (output->sequence != sequence) { throw std::logic_error{"stream blocks out of order"}; }
+
+        write(output->text);
+        stats.records += output->records;
+        stats.skipped += output->skipped;
+    }
+    return stats;
+}
+
+template<typename Scenario>
+auto stream(std::filesystem::path const& input, std::filesystem::path const& output) -> StreamStats
+{
+    auto const extension = input.extension();
+    auto const ndjson    = extension == ".ndjson" || extension == ".jsonl";
+
+    auto file = File{std::fopen(input.c_str(), "rb")};
+    if (!file) { throw std::runtime_error{fmt::format("can't open '{}'", input.string())}; }
+    auto out = File{std::fopen(output.c_str(), "wb")};
+    if (!out) { throw std::runtime_error{fmt::format("can't open '{}'", output.string())}; }
+
+    auto const workers = hardwareThreads();
+    auto parser        = Parser<Scenario>{ndjson};
+    auto blocks        = std::deque<SpscQueue<Block>>{};
+    auto outputs       = std::deque<SpscQueue<Output>>{};
+    for (auto w = std::size_t{0}; w < workers; ++w)
+    {
+        blocks.emplace_back(queueDepth);
+        outputs.emplace_back(queueDepth);
+    }
+
+    auto stats        = StreamStats{.records = 0, .skipped = 0};
+    auto readFailure  = std::exception_ptr{};
+    auto failures     = std::vector<std::exception_ptr>(workers);
+    auto writeFailure = std::exception_ptr{};
+
+    {
+        auto reader = std::jthread{[&] {
+            try
+            {
+                readStage<Scenario>(file.get(), parser, blocks);
+            }
+            catch (...)
+            {
+                readFailure = std::current_exception();
+            }
+            for (auto& queue : blocks) { queue.close(); }
+        }};
+
+        auto pool = std::vector<std::jthread>{};
+        for (auto w = std::size_t{0}; w < workers; ++w)
+        {
+            pool.emplace_back([&, w] {
+                try
+                {
+                    computeStage<Scenario>(parser, blocks[w], outputs[w]);
+                }
+                catch (...)
+                {
+                    failures[w] = std::current_exception();
+                    while (blocks[w].pop()) {}
+                }
+                outputs[w].close();
+            });
+        }
+
+        try
+        {
+            stats = writeStage<Scenario>(out.get(), outputs);
+        }
+        catch (...)
+        {
+            writeFailure = std::current_exception();
+        }
+
+        // after a failure the other stages may still be blocked on a full queue
+        for (auto& queue : outputs)
+        {
+            while (queue.pop()) {}
+        }
+    }
+
+    if (readFailure) { std::rethrow_exception(readFailure); }
+    for (auto const& failure : failures)
+    {
+        if (failure) { std::rethrow_exception(failure); }
+    }
+    if (writeFailure) { std::rethrow_exception(writeFailure); }
+    if (std::fclose(out.release()) != 0) { throw std::runtime_error{"write error"}; }
+
+    return stats;
+}
+
+}  // namespace
+
+auto parseScenarioKind(std::string_view name) -> std::optional<ScenarioKind>
+{
+    if (name == "flights") { return ScenarioKind::Flight; }
+    if (name == "containers") { return ScenarioKind::Container; }
+    if (name == "panels") { return ScenarioKind::Panel; }
+    return std::nullopt;
+}
+
+auto streamScenarios(ScenarioKind kind, std::filesystem::path const& input, std::filesystem::path const& output)
+    -> StreamStats
+{
+    switch (kind)
+    {
+        case ScenarioKind::Flight: return stream<FlightScenario>(input, output);
+        case ScenarioKind::Container: return stream<ContainerScenario>(input, output);
+        case ScenarioKind::Panel: return stream<PanelScenario>(input, output);
+    }
+    return {};
+}
+
+}  // namespace tug
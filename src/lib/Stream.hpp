@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace tug
+{
+
+enum class ScenarioKind
+{
+    Flight,
+    Container,
+    Panel,
+};
+
+struct StreamStats
+{
+    std::size_t records;
+    std::size_t skipped;  // lines with missing, malformed, non-finite or out-of-range fields
+};
+
+[[nodiscard]] auto parseScenarioKind(std::string_view name) -> std::optional<ScenarioKind>;
+
+// Evaluates every scenario of a CSV (with header) or NDJSON file, picked by the
+// extension, and writes inputs plus results as CSV in the same order. One
+// thread cuts the input into line-aligned blocks, one worker per hardware
+// thread parses, computes and formats them, and the writer puts the finished
+// text back in input order. Bounded queues between the stages keep memory use
+// constant no matter how large the input is.
+//
+// Throws std::runtime_error if a file can't be opened or the CSV header lacks
+// a field.
+auto streamScenarios(ScenarioKind kind, std::filesystem::path const& input, std::filesystem::path const& output)
+    -> StreamStats;
+
+}  // namespace tug
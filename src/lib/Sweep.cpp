@@ -0,0 +1,529 @@
+#include "Sweep.hpp"
+
+#include "File.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+#include <mp-units/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace tug
+{
+
+namespace
+{
+
+struct Worker
+{
+    pid_t pid;
+    int socket;
+    std::string received;
+    std::optional<std::size_t> shard;
+};
+
+// Closes and reaps the workers on every way out of the coordinator. A closed
+// socket ends the worker's request loop, so waitpid() doesn't hang.
+class WorkerGuard
+{
+public:
+    explicit WorkerGuard(std::vector<Worker>& workers) : _workers{workers} {}
+    WorkerGuard(WorkerGuard const&)                    = delete;
+    auto operator=(WorkerGuard const&) -> WorkerGuard& = delete;
+
+    ~WorkerGuard()
+    {
+        for (auto& worker : _workers)
+        {
+            if (worker.socket >= 0) { ::close(worker.socket); }
+            while (::waitpid(worker.pid, nullptr, 0) < 0 && errno == EINTR) {}
+        }
+    }
+
+private:
+    std::vector<Worker>& _workers;
+};
+
+[[noreturn]] auto throwSystemError(char const* what) -> void
+{
+    throw std::system_error{errno, std::generic_category(), what};
+}
+
+// Protocol and checkpoint lines, floats as hex so they round-trip exactly:
+//   coordinator -> worker   "shard <id> <first> <last>"
+//   worker -> coordinator   "done <id> <scenarios> <total> <best> <best-profit> <worst> <worst-profit>"
+//   checkpoint              "sweep <size> <shard-size> <fingerprint>" followed by "done" lines
+[[nodiscard]] auto formatDone(std::size_t shard, SweepResult const& r) -> std::string
+{
+    return fmt::format("done {} {} {:a} {} {:a} {} {:a}\n", shard, r.scenarios,
+                       r.total.numerical_value_in(finance::euro), r.best,
+                       r.bestProfit.numerical_value_in(finance::euro), r.worst,
+                       r.worstProfit.numerical_value_in(finance::euro));
+}
+
+// Every field has to be consumed completely, a line glued to a torn one is rejected
+[[nodiscard]] auto parseDone(std::string const& line) -> std::optional<std::pair<std::size_t, SweepResult>>
+{
+    auto ss     = std::istringstream{line};
+    auto fields = std::vector<std::string>{};
+    for (auto field = std::string{}; ss >> field;) { fields.push_back(std::move(field)); }
+    if (fields.size() != 8 || fields[0] != "done") { return std::nullopt; }
+
+    auto const integer = [](std::string const& text) -> std::optional<std::size_t> {
+        auto value           = std::size_t{0};
+        auto const [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || end != text.data() + text.size()) { return std::nullopt; }
+        return value;
+    };
+    auto const real = [](std::string const& text) -> std::optional<double> {
+        char* end        = nullptr;
+        auto const value = std::strtod(text.c_str(), &end);
+        if (end != text.c_str() + text.size()) { return std::nullopt; }
+        return value;
+    };
+
+    auto const shard     = integer(fields[1]);
+    auto const scenarios = integer(fields[2]);
+    auto const total     = real(fields[3]);
+    auto const best      = integer(fields[4]);
+    auto const bestValue = real(fields[5]);
+    auto const worst     = integer(fields[6]);
+    auto const worstVal  = real(fields[7]);
+    if (!shard || !scenarios || !total || !best || !bestValue || !worst || !worstVal) { return std::nullopt; }
+
+    return std::pair{*shard, SweepResult{
+                                 .scenarios   = *scenarios,
+                                 .total       = *total * finance::euro,
+                                 .best        = *best,
+                                 .bestProfit  = *bestValue * finance::euro,
+                                 .worst       = *worst,
+                                 .worstProfit = *worstVal * finance::euro,
+                             }};
+}
+
+[[nodiscard]] auto shardRange(std::size_t shard, std::size_t size, std::size_t shardSize)
+    -> std::pair<std::size_t, std::size_t>
+{
+    auto const first = std::min(shard * shardSize, size);
+    return {first, std::min(first + shardSize, size)};
+}
+
+// FNV-1a over every input of the sweep, an edited seeds file with the same
+// number of rows must not reuse the shards of the old one
+class Fingerprint
+{
+public:
+    auto add(std::string_view bytes) -> void
+    {
+        for (auto byte : bytes)
+        {
+            _hash ^= static_cast<unsigned char>(byte);
+            _hash *= 0x100000001b3ULL;
+        }
+    }
+
+    template<typename T>
+        requires std::is_arithmetic_v<T>
+    auto add(T value) -> void
+    {
+        auto const bytes = std::bit_cast<std::array<char, sizeof(T)>>(value);
+        add(std::string_view{bytes.data(), bytes.size()});
+    }
+
+    auto add(Quantity auto q) -> void { add(q.numerical_value_in(q.unit)); }
+
+    [[nodiscard]] auto value() const noexcept -> std::uint64_t { return _hash; }
+
+private:
+    std::uint64_t _hash{0xcbf29ce484222325ULL};
+};
+
+[[nodiscard]] auto fingerprint(Sweep const& sweep) -> std::uint64_t
+{
+    auto hash = Fingerprint{};
+
+    hash.add(sweep.containers.size());
+    for (auto const& gc : sweep.containers)
+    {
+        hash.add(gc.container.length);
+        hash.add(gc.container.width);
+        hash.add(gc.container.height);
+        hash.add(gc.rack.depth);
+        hash.add(gc.rack.width);
+        hash.add(gc.rack.height);
+        hash.add(gc.rack.shelfs);
+        hash.add(gc.rack.tray);
+        hash.add(gc.light.power);
+        hash.add(gc.light.efficiency);
+        hash.add(gc.rows);
+        hash.add(gc.lightsPerShelf);
+    }
+
+    hash.add(sweep.crops.size());
+    for (auto const& crop : sweep.crops)
+    {
+        hash.add(crop.name.size());
+        hash.add(crop.name);
+        hash.add(crop.price);
+        hash.add(crop.seeds);
+        hash.add(crop.water);
+        hash.add(crop.light);
+        hash.add(crop.germination);
+        hash.add(crop.grow);
+        hash.add(crop.rest);
+        hash.add(crop.yield);
+        hash.add(crop.msrp);
+    }
+
+    hash.add(sweep.sites.size());
+    for (auto const& site : sweep.sites)
+    {
+        hash.add(site.irradiance);
+        hash.add(site.daylight);
+    }
+
+    hash.add(sweep.tariffs.size());
+    for (auto const& tariff : sweep.tariffs) { hash.add(tariff); }
+    hash.add(sweep.roofPanels);
+
+    return hash.value();
+}
+
+auto sendLine(int socket, std::string const& line) -> bool
+{
+    auto data = std::string_view{line};
+    while (!data.empty())
+    {
+        auto const sent = ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) { continue; }
+        if (sent <= 0) { return false; }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+    return true;
+}
+
+[[nodiscard]] auto spawn(std::vector<std::string> const& command) -> Worker
+{
+    auto fds = std::array<int, 2>{};
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) != 0) { throwSystemError("socketpair"); }
+
+    auto args = std::vector<char*>{};
+    for (auto const& arg : command) { args.push_back(const_cast<char*>(arg.c_str())); }
+    args.push_back(nullptr);
+
+    auto const pid = ::fork();
+    if (pid < 0) { throwSystemError("fork"); }
+    if (pid == 0)
+    {
+        // dup2 clears close-on-exec on the copies
+        ::dup2(fds[1], STDIN_FILENO);
+        ::dup2(fds[1], STDOUT_FILENO);
+        ::execv(args[0], args.data());
+        ::_exit(127);
+    }
+
+    ::close(fds[1]);
+    return Worker{.pid = pid, .socket = fds[0], .received = {}, .shard = std::nullopt};
+}
+
+auto commit(std::FILE* checkpoint, std::string const& line) -> void
+{
+    if (std::fputs(line.c_str(), checkpoint) == EOF || std::fflush(checkpoint) != 0) { throwSystemError("checkpoint"); }
+    if (::fsync(::fileno(checkpoint)) != 0) { throwSystemError("checkpoint fsync"); }
+}
+
+// Reads the finished shards of an earlier run and reopens the file for
+// appending. A torn last line is cut off first, so the next record starts on a
+// line of its own. Records that don't cover their whole shard are dropped.
+[[nodiscard]] auto openCheckpoint(std::filesystem::path const& path, std::string const& header, std::size_t size,
+                                  std::size_t shardSize, std::vector<std::optional<SweepResult>>& results) -> File
+{
+    auto content = std::string{};
+    if (auto in = std::ifstream{path, std::ios::binary}) { content.assign(std::istreambuf_iterator<char>{in}, {}); }
+
+    auto const newline = content.rfind('\n');
+    content.resize(newline == std::string::npos ? 0 : newline + 1);
+
+    auto lines = std::istringstream{content};
+    auto line  = std::string{};
+    if (std::getline(lines, line) && line != header)
+    {
+        throw std::runtime_error{fmt::format("checkpoint '{}' belongs to a different sweep", path.string())};
+    }
+
+    while (std::getline(lines, line))
+    {
+        auto done = parseDone(line);
+        if (!done || done->first >= results.size()) { continue; }
+
+        auto const [first, last] = shardRange(done->first, size, shardSize);
+        if (done->second.scenarios == last - first) { results[done->first] = done->second; }
+    }
+
+    if (std::filesystem::exists(path) && std::filesystem::file_size(path) != content.size())
+    {
+        std::filesystem::resize_file(path, content.size());
+    }
+
+    auto file = File{std::fopen(path.c_str(), "a")};
+    if (!file) { throwSystemError("checkpoint"); }
+    if (content.empty()) { commit(file.get(), header + "\n"); }
+    return file;
+}
+
+}  // namespace
+
+auto monthlyProfit(Sweep const& sweep, std::size_t scenario) -> quantity<finance::euro>
+{
+    using namespace mp_units::si::unit_symbols;
+    using namespace finance::unit_symbols;
+
+    auto const tariff = sweep.tariffs[scenario % sweep.tariffs.size()];
+    scenario /= sweep.tariffs.size();
+    auto const& site = sweep.sites[scenario % sweep.sites.size()];
+    scenario /= sweep.sites.size();
+    auto const& plant = sweep.crops[scenario % sweep.crops.size()];
+    scenario /= sweep.crops.size();
+    auto const& gc = sweep.containers[scenario];
+
+    auto const tray = trayEconomics(plant);
+
+    auto const roof = SolarPanel{
+        .width      = gc.container.width,
+        .height     = gc.container.length.numerical_value_in(m) * m,
+        .efficiency = sweep.roofPanels,
+    };
+
+    auto const consumed = (gc.powerLights() + coolingPower(gc)) * plant.light * (30.0 * d);
+    auto const produced = roof.energy(site) * 30.0;
+
+    auto const grid   = consumed.numerical_value_in(kW * h) - produced.numerical_value_in(kW * h);
+    auto const bought = std::max(grid, 0.0) * kW * h;
+    auto const crops  = (tray.margin() * gc.trays() * tray.cycles).numerical_value_in(EUR);
+    auto const energy = (tariff * bought).numerical_value_in(EUR);
+    return (crops - energy) * EUR;
+}
+
+auto SweepResult::add(std::size_t scenario, quantity<finance::euro> profit) -> void
+{
+    ++scenarios;
+    total += profit;
+    if (profit > bestProfit)
+    {
+        best       = scenario;
+        bestProfit = profit;
+    }
+    if (profit < worstProfit)
+    {
+        worst       = scenario;
+        worstProfit = profit;
+    }
+}
+
+auto SweepResult::merge(SweepResult const& other) -> void
+{
+    scenarios += other.scenarios;
+    total += other.total;
+    if (other.bestProfit > bestProfit || (other.bestProfit == bestProfit && other.best < best))
+    {
+        best       = other.best;
+        bestProfit = other.bestProfit;
+    }
+    if (other.worstProfit < worstProfit || (other.worstProfit == worstProfit && other.worst < worst))
+    {
+        worst       = other.worst;
+        worstProfit = other.worstProfit;
+    }
+}
+
+auto reduceShard(Sweep const& sweep, std::size_t first, std::size_t last) -> SweepResult
+{
+    auto result = SweepResult{};
+    for (auto scenario = first; scenario < last; ++scenario) { result.add(scenario, monthlyProfit(sweep, scenario)); }
+    return result;
+}
+
+auto runCoordinator(Sweep const& sweep, SweepOptions const& options) -> SweepResult
+{
+    if (options.workers == 0) { throw std::invalid_argument{"sweep needs at least one worker"}; }
+    if (options.workerCommand.empty()) { throw std::invalid_argument{"sweep needs a worker command"}; }
+
+    auto const size      = sweep.size();
+    auto const shardSize = std::max<std::size_t>(options.shardSize, 1);
+    auto const shards    = (size + shardSize - 1) / shardSize;
+
+    auto results    = std::vector<std::optional<SweepResult>>(shards);
+    auto const head = fmt::format("sweep {} {} {:016x}", size, shardSize, fingerprint(sweep));
+    auto checkpoint = openCheckpoint(options.checkpoint, head, size, shardSize, results);
+
+    auto pending = std::deque<std::size_t>{};
+    for (auto shard = std::size_t{0}; shard < shards; ++shard)
+    {
+        if (!results[shard]) { pending.push_back(shard); }
+    }
+
+    auto workers = std::vector<Worker>{};
+    auto guard   = WorkerGuard{workers};
+    for (auto i = std::size_t{0}; i < std::min(options.workers, pending.size()); ++i)
+    {
+        workers.push_back(spawn(options.workerCommand));
+    }
+
+    // a failed send leaves the shard queued, poll() reports the closed socket
+    auto const dispatch = [&](Worker& worker) {
+        if (pending.empty()) { return; }
+
+        auto const shard         = pending.front();
+        auto const [first, last] = shardRange(shard, size, shardSize);
+        if (!sendLine(worker.socket, fmt::format("shard {} {} {}\n", shard, first, last))) { return; }
+
+        pending.pop_front();
+        worker.shard = shard;
+    };
+
+    auto const retire = [&](Worker& worker) {
+        ::close(worker.socket);
+        worker.socket = -1;
+        if (worker.shard) { pending.push_front(*worker.shard); }
+        worker.shard.reset();
+    };
+
+    for (auto& worker : workers) { dispatch(worker); }
+
+    auto remaining = static_cast<std::size_t>(std::ranges::count_if(results, [](auto const& r) { return !r; }));
+    auto buffer    = std::array<char, 4096>{};
+    auto fds       = std::vector<pollfd>{};
+
+    while (remaining > 0)
+    {
+        fds.clear();
+        for (auto const& worker : workers)
+        {
+            if (worker.socket >= 0) { fds.push_back({.fd = worker.socket, .events = POLLIN, .revents = 0}); }
+        }
+        if (fds.empty()) { throw std::runtime_error{"all sweep workers died"}; }
+
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR) { continue; }
+            throwSystemError("poll");
+        }
+
+        for (auto& worker : workers)
+        {
+            auto const ready = std::ranges::find(fds, worker.socket, &pollfd::fd);
+            if (worker.socket < 0 || ready == fds.end() || ready->revents == 0) { continue; }
+
+            auto const received = ::read(worker.socket, buffer.data(), buffer.size());
+            if (received < 0 && errno == EINTR) { continue; }
+            if (received <= 0)
+            {
+                retire(worker);
+                continue;
+            }
+            worker.received.append(buffer.data(), static_cast<std::size_t>(received));
+
+            for (auto nl = worker.received.find('\n'); nl != std::string::npos; nl = worker.received.find('\n'))
+            {
+                auto const line = worker.received.substr(0, nl + 1);
+                worker.received.erase(0, nl + 1);
+
+                auto done = parseDone(line);
+                if (!done || done->first >= shards || results[done->first]) { continue; }
+
+                auto const [first, last] = shardRange(done->first, size, shardSize);
+                if (done->second.scenarios != last - first)
+                {
+                    throw std::runtime_error{fmt::format("worker answered shard {} with {} of {} scenarios",
+                                                         done->first, done->second.scenarios, last - first)};
+                }
+
+                commit(checkpoint.get(), line);
+                results[done->first] = done->second;
+                --remaining;
+
+                fmt::println(stderr, "shard {}/{} done", shards - remaining, shards);
+                if (worker.shard == done->first) { worker.shard.reset(); }
+            }
+
+            if (!worker.shard) { dispatch(worker); }
+        }
+
+        // shards of a retired worker go to whoever is idle
+        for (auto& worker : workers)
+        {
+            if (worker.socket >= 0 && !worker.shard) { dispatch(worker); }
+        }
+    }
+
+    auto result = SweepResult{};
+    for (auto const& shard : results) { result.merge(*shard); }
+    return result;
+}
+
+auto runWorker(Sweep const& sweep, std::istream& in, std::ostream& out) -> void
+{
+    auto line = std::string{};
+    while (std::getline(in, line))
+    {
+        auto ss    = std::istringstream{line};
+        auto tag   = std::string{};
+        auto shard = std::size_t{0};
+        auto first = std::size_t{0};
+        auto last  = std::size_t{0};
+        if (!(ss >> tag >> shard >> first >> last) || tag != "shard") { continue; }
+
+        out << formatDone(shard, reduceShard(sweep, first, std::min(last, sweep.size()))) << std::flush;
+    }
+}
+
+auto report(Sweep const& sweep, SweepResult const& result) -> void
+{
+    using namespace finance::unit_symbols;
+
+    auto const name = [&](std::size_t scenario) {
+        auto const& plant = sweep.crops[scenario / sweep.tariffs.size() / sweep.sites.size() % sweep.crops.size()];
+        return plant.name;
+    };
+
+    fmt::println("Sweep:");
+    fmt::println("-----");
+    fmt::println("Containers:   {}", sweep.containers.size());
+    fmt::println("Crops:        {}", sweep.crops.size());
+    fmt::println("Sites:        {}", sweep.sites.size());
+    fmt::println("Tariffs:      {}", sweep.tariffs.size());
+    fmt::println("Scenarios:    {}\n", result.scenarios);
+
+    if (result.scenarios == 0) { return; }
+
+    fmt::println("Profit-Mean:  {::N[.2f]}", (result.total / static_cast<double>(result.scenarios)).in(EUR));
+    fmt::println("Profit-Best:  {::N[.2f]} (#{} {})", result.bestProfit.in(EUR), result.best, name(result.best));
+    fmt::println("Profit-Worst: {::N[.2f]} (#{} {})", result.worstProfit.in(EUR), result.worst, name(result.worst));
+    fmt::println("");
+}
+
+}  // namespace tug
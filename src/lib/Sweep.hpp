@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Finance.hpp"
+#include "Microgreens.hpp"
+#include "SolarPanel.hpp"
+
+#include <mp-units/systems/isq.h>
+#include <mp-units/systems/si.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace tug
+{
+
+using namespace mp_units;
+
+// Cartesian product of containers x crops x sites x tariffs, scenarios are
+// numbered in that order with the tariff changing fastest.
+struct Sweep
+{
+    std::vector<GrowContainer> containers;
+    std::vector<Microgreen> crops;
+    std::vector<SolarPanel::Location> sites;
+    std::vector<quantity<finance::euro / (si::kilo<si::watt> * si::hour)>> tariffs;
+    quantity<isq::maximum_efficiency[percent]> roofPanels;  // efficiency of the solar array on the roof
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return containers.size() * crops.size() * sites.size() * tariffs.size();
+    }
+};
+
+// Monthly profit of one scenario: crop margin minus the grid energy the roof
+// array doesn't cover
+[[nodiscard]] auto monthlyProfit(Sweep const& sweep, std::size_t scenario) -> quantity<finance::euro>;
+
+struct SweepResult
+{
+    std::size_t scenarios{0};
+    quantity<finance::euro> total{0.0 * finance::euro};
+    std::size_t best{0};
+    quantity<finance::euro> bestProfit{-std::numeric_limits<double>::infinity() * finance::euro};
+    std::size_t worst{0};
+    quantity<finance::euro> worstProfit{std::numeric_limits<double>::infinity() * finance::euro};
+
+    auto add(std::size_t scenario, quantity<finance::euro> profit) -> void;
+    auto merge(SweepResult const& other) -> void;
+};
+
+[[nodiscard]] auto reduceShard(Sweep const& sweep, std::size_t first, std::size_t last) -> SweepResult;
+
+struct SweepOptions
+{
+    std::size_t shardSize;
+    std::size_t workers;
+    std::filesystem::path checkpoint;
+    std::vector<std::string> workerCommand;  // program and arguments that start runWorker()
+};
+
+// Splits the sweep into fixed shards and hands them to worker processes that
+// talk line based over a Unix domain socket on their stdin and stdout. Every
+// finished shard is appended to the checkpoint and fsync'ed first, so a rerun
+// with the same inputs and shard size skips it. Shards of a crashed worker go
+// back to the queue. Partial results are merged in shard order, so the result
+// doesn't depend on the number of workers or on timing.
+//
+// Throws std::invalid_argument without workers or a worker command,
+// std::runtime_error if the checkpoint belongs to a different sweep or every
+// worker died, std::system_error if the checkpoint can't be written. Workers
+// are closed and reaped on every way out.
+[[nodiscard]] auto runCoordinator(Sweep const& sweep, SweepOptions const& options) -> SweepResult;
+
+// Answers shard requests from `in` until it is closed
+auto runWorker(Sweep const& sweep, std::istream& in, std::ostream& out) -> void;
+
+auto report(Sweep const& sweep, SweepResult const& result) -> void;
+
+}  // namespace tug
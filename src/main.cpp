@@ -1,8 +1,15 @@
 #include "Atmosphere.hpp"
+#include "CashFlow.hpp"
+#include "Fleet.hpp"
 #include "Hydrogen.hpp"
+#include "LightSchedule.hpp"
 #include "Microgreens.hpp"
 #include "QuadCopter.hpp"
+#include "RackLayout.hpp"
+#include "Shading.hpp"
 #include "SolarPanel.hpp"
+#include "Stream.hpp"
+#include "Sweep.hpp"
 
 #include <mp-units/systems/cgs.h>
 #include <mp-units/systems/international.h>
@@ -10,6 +17,16 @@
 #include <mp-units/systems/si.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 
 auto main(int argc, char const** argv) -> int
 {
@@ -18,6 +35,101 @@ auto main(int argc, char const** argv) -> int
     using namespace mp_units::international::unit_symbols;
     using namespace tug::finance::unit_symbols;
 
+    // drone-math stream <flights|containers|panels> <input.csv|input.ndjson> <output.csv>
+    if (argc == 5 && std::string_view{argv[1]} == "stream")
+    {
+        auto const kind = tug::parseScenarioKind(argv[2]);
+        if (!kind)
+        {
+            fmt::println(stderr, "unknown scenario kind '{}', expected flights, containers or panels", argv[2]);
+            return EXIT_FAILURE;
+        }
+
+        try
+        {
+            auto const stats = tug::streamScenarios(*kind, argv[3], argv[4]);
+            fmt::println("Records: {}", stats.records);
+            fmt::println("Skipped: {}", stats.skipped);
+        }
+        catch (std::exception const& e)
+        {
+            fmt::println(stderr, "{}", e.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // drone-math fleet <orders> <drones>, orders arrive in batches of 1'000
+    if (argc == 4 && std::string_view{argv[1]} == "fleet")
+    {
+        auto const airframe = [](std::string name, auto weight, auto area, auto payload, auto battery, auto charger) {
+            return tug::Airframe{
+                .name       = std::move(name),
+                .copter     = {.weight                = weight,
+                               .frontalArea           = area,
+                               .thrustEfficiency      = 130.0 * percent,
+                               .aerodynamicEfficiency = 70.0 * percent},
+                .maxPayload = payload,
+                .battery    = battery,
+                .charger    = charger,
+                .reserve    = 20.0 * percent,
+            };
+        };
+
+        try
+        {
+            auto const orders = std::stoul(argv[2]);
+            auto const drones = std::stoul(argv[3]);
+
+            auto fleet = tug::Fleet{
+                .airframes = {airframe("Light", 2.0 * kg, 200.0 * square(cm), 1.5 * kg, 0.8 * kW * h, 300.0 * W),
+                              airframe("X4", 5.0 * kg, 300.0 * square(cm), 2.5 * kg, 1.2 * kW * h, 600.0 * W),
+                              airframe("Heavy", 12.0 * kg, 600.0 * square(cm), 8.0 * kg, 3.0 * kW * h, 1'500.0 * W)},
+                .drones    = {},
+                .shift     = 8.0 * h,
+            };
+            for (auto drone = std::size_t{0}; drone < drones; ++drone)
+            {
+                fleet.drones.push_back(drone % 5 < 2 ? 0 : (drone % 5 < 4 ? 1 : 2));
+            }
+
+            auto rng        = std::mt19937{42};
+            auto distance   = std::uniform_real_distribution<double>{1.0, 10.0};
+            auto speed      = std::uniform_real_distribution<double>{30.0, 100.0};
+            auto payload    = std::uniform_real_distribution<double>{0.2, 2.4};
+            auto deliveries = std::vector<tug::Delivery>{};
+            for (auto i = std::size_t{0}; i < orders; ++i)
+            {
+                auto const leg = tug::Flight{
+                    .distance = distance(rng) * km,
+                    .altitude = 500.0 * m,
+                    .speed    = speed(rng) * km / h,
+                };
+                deliveries.push_back({.leg = leg, .payload = payload(rng) * kg});
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            auto planner     = tug::FleetPlanner{fleet};
+            for (auto first = std::size_t{0}; first < deliveries.size(); first += 1'000)
+            {
+                planner.add(std::span{deliveries}.subspan(first, std::min<std::size_t>(1'000, orders - first)));
+            }
+            auto const added = std::chrono::steady_clock::now();
+            planner.optimize();
+            auto const done = std::chrono::steady_clock::now();
+
+            tug::report(planner);
+            fmt::println("Add:         {:.1f} ms", std::chrono::duration<double, std::milli>{added - start}.count());
+            fmt::println("Optimize:    {:.1f} ms", std::chrono::duration<double, std::milli>{done - added}.count());
+        }
+        catch (std::exception const& e)
+        {
+            fmt::println(stderr, "{}", e.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     // tug::compressGas();
 
     // static constexpr auto uav = tug::QuadCopter{
@@ -53,6 +165,21 @@ auto main(int argc, char const** argv) -> int
 
     // tug::report(panel, location);
 
+    // static constexpr auto roof = tug::IntermodalContainer::highCube40().outside().height;
+    // auto site = tug::Site{
+    //     .latitude   = 52.5 * deg,
+    //     .step       = 15.0 * min,
+    //     .containers = {
+    //         {.container = tug::IntermodalContainer::highCube40(), .x = 0.0 * m, .y = 0.0 * m, .z = 0.0 * m},
+    //         {.container = tug::IntermodalContainer::highCube40(), .x = 0.0 * m, .y = -4.0 * m, .z = 0.0 * m},
+    //         {.container = tug::IntermodalContainer::highCube40(), .x = 0.0 * m, .y = -4.0 * m, .z = roof},
+    //     },
+    //     .obstacles = {{.x = 10.0 * m, .y = 0.5 * m, .z = roof,
+    //                    .sizeX = 1.2 * m, .sizeY = 1.0 * m, .height = 1.1 * m}},
+    //     .panels    = {{.panel = panel, .container = 0, .x = 0.0 * m, .y = 0.0 * m, .rack = 0.2 * m}},
+    // };
+    // tug::report(site, tug::computeShading(site));
+
     static constexpr auto light = tug::GrowLight{
         .power      = 15.0 * W,
         .efficiency = 90.0 * percent,
@@ -79,9 +206,116 @@ auto main(int argc, char const** argv) -> int
         .lightsPerShelf = 2 * one,
     };
 
+    static constexpr auto eurPerUsd = 0.92 * EUR / USD;
+
+    auto const makeSweep = [](std::filesystem::path const& seeds) {
+        auto sweep = tug::Sweep{
+            .containers = {},
+            .crops      = tug::loadMicrogreens(seeds, eurPerUsd),
+            .sites =
+                {
+                    {.irradiance = 600.0 * W / m2, .daylight = 4.0 * h},
+                    {.irradiance = 800.0 * W / m2, .daylight = 6.0 * h},
+                    {.irradiance = 1'000.0 * W / m2, .daylight = 8.0 * h},
+                    {.irradiance = 1'269.0 * W / m2, .daylight = 8.0 * h},
+                },
+            .tariffs    = {0.15 * EUR / (kW * h), 0.20 * EUR / (kW * h), 0.25 * EUR / (kW * h), 0.31 * EUR / (kW * h),
+                           0.40 * EUR / (kW * h)},
+            .roofPanels = 18.0 * percent,
+        };
+
+        for (auto const& box : {tug::IntermodalContainer::standard20(), tug::IntermodalContainer::standard40(),
+                                tug::IntermodalContainer::highCube40()})
+        {
+            for (auto lights : {1, 2, 3})
+            {
+                auto variant           = gc;
+                variant.container      = box;
+                variant.lightsPerShelf = lights * one;
+                sweep.containers.push_back(variant);
+            }
+        }
+        return sweep;
+    };
+
+    // drone-math sweep <seeds.csv> <checkpoint> <workers>
+    if (argc == 5 && std::string_view{argv[1]} == "sweep")
+    {
+        try
+        {
+            auto const sweep  = makeSweep(argv[2]);
+            auto const result = tug::runCoordinator(sweep, tug::SweepOptions{
+                                                               .shardSize     = 256,
+                                                               .workers       = std::stoul(argv[4]),
+                                                               .checkpoint    = argv[3],
+                                                               .workerCommand = {"/proc/self/exe", "worker", argv[2]},
+                                                           });
+            tug::report(sweep, result);
+        }
+        catch (std::exception const& e)
+        {
+            fmt::println(stderr, "{}", e.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // started by the sweep coordinator, shard requests arrive on stdin
+    if (argc == 3 && std::string_view{argv[1]} == "worker")
+    {
+        tug::runWorker(makeSweep(argv[2]), std::cin, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    // static constexpr auto racks = std::array{
+    //     rack,
+    //     tug::GrowRack{.depth = 0.6 * m, .width = 0.6 * m, .height = 2.2 * m, .shelfs = 6 * one, .tray = 25.0 * cm},
+    // };
+    // static constexpr auto clearance = tug::RackClearance{
+    //     .aisle   = 0.8 * m,
+    //     .door    = 1.0 * m,
+    //     .ceiling = 0.2 * m,
+    // };
+    // static constexpr auto goal = tug::RackGoal{
+    //     .light          = light,
+    //     .lightsPerShelf = 2 * one,
+    //     .maxCooling     = 3.0 * kW,
+    //     .coolingWeight  = 0.01 * m2 / W,
+    // };
+    // tug::report(tug::optimizeRackLayout(tug::IntermodalContainer::highCube40(), racks, clearance, goal), racks);
+
+    // auto const investment = tug::Investment{
+    //     .container = {.capex = 6'000.0 * EUR, .life = 20},
+    //     .lights    = {.capex = 2'400.0 * EUR, .life = 5},
+    //     .panels    = {.capex = 3'500.0 * EUR, .life = 25},
+    //     .revenue   = 40'000.0 * EUR,
+    //     .opex      = 22'000.0 * EUR,
+    //     .seeds     = 4'000.0 * USD,
+    // };
+    // auto const model = tug::CashFlowModel{
+    //     .years        = 10,
+    //     .discountRate = 6.0 * percent,
+    //     .taxRate      = 30.0 * percent,
+    //     .eurPerUsd    = {0.92 * EUR / USD, 0.95 * EUR / USD, 1.0 * EUR / USD},
+    // };
+    // auto const investments = std::vector<tug::Investment>(10'000, investment);
+    // tug::report(model, tug::evaluateCashFlows(model, investments));
+
+    // auto prices = tug::DayAheadPrices{.slot = 60.0 * min, .price = {}, .cop = {}};
+    // for (auto hour = 0; hour < 24; ++hour)
+    // {
+    //     auto const night = hour < 6 || hour >= 22;
+    //     prices.price.push_back((night ? 0.18 : 0.34) * EUR / (kW * h));
+    //     prices.cop.push_back((night ? 4.0 : 2.5) * one);
+    // }
+    // auto crops = tug::loadMicrogreens(argv[1], eurPerUsd);
+    // crops.resize(std::min(crops.size(), static_cast<std::size_t>(gc.shelfs().numerical_value_in(one))));
+    // auto const jobs = std::vector<tug::LightingJob>(50, {.container = gc, .crops = crops});
+    // for (auto const& schedule : tug::scheduleFleet(jobs, prices, 2)) { tug::report(schedule, prices); }
+
     if (argc == 2)
     {
-        auto plants = tug::loadMicrogreens(argv[1]);
+        auto plants = tug::loadMicrogreens(argv[1], eurPerUsd);
         auto less   = [](auto const& l, auto const& r) { return (l.yield / l.grow) < (r.yield / r.grow); };
         std::ranges::sort(plants, less);
 